@@ -65,6 +65,13 @@ travis_run catkin run_tests --no-status --continue-on-failure --summarize
 catkin_test_results
 result=$?
 
+# track performance of the tactile visualization pipeline (headless)
+travis_run_true rosrun rviz_tactile_plugins tactile_pipeline_benchmark
+# end-to-end pipeline throughput, measured by tactile_bench's opt-in rostest
+travis_run_true catkin build tactile_bench --no-deps --no-status --cmake-args -DTACTILE_BENCHMARKS=ON --make-args tests --
+travis_run_true catkin run_tests tactile_bench --no-deps --no-status
+travis_run_true cat /tmp/tactile_pipeline_benchmark.json
+
 echo "Travis script has finished successfully"
 HIT_ENDOFSCRIPT=true
 exit $result
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Headless benchmark of the tactile value pipeline (ingest, normalization, color mapping),
+ * running on a synthetic skin without any rendering. Results are written as JSON to stdout.
+ *
+ * usage: tactile_pipeline_benchmark [sensors=10] [taxels=1000] [frames=1000]
+ */
+
+#include "../src/tactile_pipeline.h"
+#include "../src/color_lut.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace rviz::tactile;
+typedef std::chrono::steady_clock Clock;
+
+/// synthetic skin: each sensor is a square patch of taxels, pressed by a moving blob
+class SyntheticSkin
+{
+public:
+  SyntheticSkin(size_t sensors, size_t taxels)
+    : sensors_(sensors), taxels_(taxels), side_(std::ceil(std::sqrt(double(taxels))))
+    , noise_(0, 10), values_(taxels)
+  {}
+
+  /// raw readings (0..4095) of sensor s in frame f
+  const std::vector<float> &readings(size_t s, size_t f)
+  {
+    // blob center moving on a circle, phase shifted per sensor
+    const float phase = 0.01f * f + 2.0f * M_PI * s / sensors_;
+    const float cx = 0.5f * side_ * (1 + 0.5f * std::cos(phase));
+    const float cy = 0.5f * side_ * (1 + 0.5f * std::sin(phase));
+    const float sigma2 = 2.0f * 0.01f * side_ * side_;
+    for (size_t i = 0; i < taxels_; ++i) {
+      const float dx = i % side_ - cx, dy = i / side_ - cy;
+      const float v = 4000.0f * std::exp(-(dx*dx + dy*dy) / sigma2) + noise_(rng_);
+      values_[i] = std::min(std::max(v, 0.0f), 4095.0f);
+    }
+    return values_;
+  }
+
+private:
+  size_t sensors_, taxels_, side_;
+  std::mt19937 rng_;
+  std::normal_distribution<float> noise_;
+  std::vector<float> values_;
+};
+
+static double seconds(Clock::duration d)
+{
+  return std::chrono::duration<double>(d).count();
+}
+
+int main(int argc, char *argv[])
+{
+  const size_t num_sensors = argc > 1 ? std::atoi(argv[1]) : 10;
+  const size_t num_taxels = argc > 2 ? std::atoi(argv[2]) : 1000;
+  const size_t num_frames = argc > 3 ? std::atoi(argv[3]) : 1000;
+  if (!num_sensors || !num_taxels || !num_frames) {
+    fprintf(stderr, "usage: %s [sensors=10] [taxels=1000] [frames=1000]\n", argv[0]);
+    return 1;
+  }
+
+  ColorLUT lut(0, 1);
+  std::vector<uint32_t> stops;
+  stops.push_back(ColorLUT::pack(0, 0, 0));
+  stops.push_back(ColorLUT::pack(0, 255, 0));
+  stops.push_back(ColorLUT::pack(255, 255, 0));
+  stops.push_back(ColorLUT::pack(255, 0, 0));
+  lut.setColors(stops);
+
+  SyntheticSkin skin(num_sensors, num_taxels);
+  std::vector<TactilePipeline> pipelines(num_sensors);
+  for (auto it = pipelines.begin(), end = pipelines.end(); it != end; ++it)
+    it->init(num_taxels);
+  std::vector<uint32_t> colors(num_taxels);  // packed color buffer, as uploaded to the GPU
+
+  Clock::duration ingest(0), normalize(0), quantize(0), map(0);
+  size_t changed = 0;
+  for (size_t f = 0; f < num_frames; ++f) {
+    for (size_t s = 0; s < num_sensors; ++s) {
+      const std::vector<float> &readings = skin.readings(s, f);
+      TactilePipeline &pipeline = pipelines[s];
+      Clock::time_point t0 = Clock::now();
+      pipeline.update(readings);
+      Clock::time_point t1 = Clock::now();
+      pipeline.normalize();
+      Clock::time_point t2 = Clock::now();
+      changed += pipeline.quantize(lut).size();
+      Clock::time_point t3 = Clock::now();
+      pipeline.map(lut, &colors.front());
+      Clock::time_point t4 = Clock::now();
+      ingest += t1 - t0;
+      normalize += t2 - t1;
+      quantize += t3 - t2;
+      map += t4 - t3;
+    }
+  }
+
+  // per-frame timings (all sensors) in microseconds
+  const double us = 1e6 / num_frames;
+  const double total = seconds(ingest + normalize + quantize + map);
+  printf("{\n");
+  printf("  \"sensors\": %zu,\n  \"taxels\": %zu,\n  \"frames\": %zu,\n", num_sensors, num_taxels, num_frames);
+  printf("  \"ingest_us\": %.3f,\n", seconds(ingest) * us);
+  printf("  \"normalize_us\": %.3f,\n", seconds(normalize) * us);
+  printf("  \"quantize_us\": %.3f,\n", seconds(quantize) * us);
+  printf("  \"map_us\": %.3f,\n", seconds(map) * us);
+  printf("  \"frame_us\": %.3f,\n", total * us);
+  printf("  \"changed_ratio\": %.4f,\n", double(changed) / (num_frames * num_sensors * num_taxels));
+  printf("  \"taxels_per_second\": %.0f\n", total > 0 ? num_frames * num_sensors * num_taxels / total : 0.0);
+  printf("}\n");
+  return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arrow_batch.h"
+
+#include <OgreHardwareBufferManager.h>
+#include <OgreSceneNode.h>
+#include <OgreCamera.h>
+
+namespace rviz {
+namespace tactile {
+
+// proportions of rviz::Arrow (default arguments), scaled by length and width
+static const Ogre::Real SHAFT_LENGTH = 1.0;
+static const Ogre::Real SHAFT_RADIUS = 0.05;
+static const Ogre::Real HEAD_LENGTH = 0.3;
+static const Ogre::Real HEAD_RADIUS = 0.1;
+static const unsigned int SEGMENTS = 12;
+
+ArrowBatch::ArrowBatch()
+  : capacity_(0)
+  , cache_(GeometryCache::instance())
+  , bounding_radius_(0)
+  , translucent_(true)
+{
+  mBox.setNull();
+  setTranslucent(false);
+  createTemplate();
+
+  mRenderOp.operationType = Ogre::RenderOperation::OT_TRIANGLE_LIST;
+  mRenderOp.useIndexes = true;
+  mRenderOp.vertexData = new Ogre::VertexData();
+  mRenderOp.indexData = new Ogre::IndexData();
+
+  Ogre::VertexDeclaration *decl = mRenderOp.vertexData->vertexDeclaration;
+  size_t offset = 0;
+  offset += decl->addElement(0, offset, Ogre::VET_FLOAT3, Ogre::VES_POSITION).getSize();
+  offset += decl->addElement(0, offset, Ogre::VET_FLOAT3, Ogre::VES_NORMAL).getSize();
+  decl->addElement(0, offset, Ogre::VET_COLOUR_ABGR, Ogre::VES_DIFFUSE);
+  mRenderOp.vertexData->vertexCount = 0;
+  mRenderOp.indexData->indexCount = 0;
+}
+
+ArrowBatch::~ArrowBatch()
+{
+  delete mRenderOp.vertexData;
+  delete mRenderOp.indexData;
+}
+
+void ArrowBatch::createTemplate()
+{
+  Vertex v;
+  v.color = 0;
+
+  // shaft: cylinder along x-axis
+  for (unsigned int i = 0; i <= SEGMENTS; ++i) {
+    const Ogre::Radian angle(Ogre::Math::TWO_PI * i / SEGMENTS);
+    const Ogre::Real c = Ogre::Math::Cos(angle), s = Ogre::Math::Sin(angle);
+    v.normal = Ogre::Vector3(0, c, s);
+    v.position = Ogre::Vector3(0, SHAFT_RADIUS * c, SHAFT_RADIUS * s);
+    template_vertices_.push_back(v);
+    v.position.x = SHAFT_LENGTH;
+    template_vertices_.push_back(v);
+  }
+  for (unsigned int i = 0; i < SEGMENTS; ++i) {
+    const Ogre::uint32 k = 2*i;
+    const Ogre::uint32 tri[] = {k, k+2, k+1, k+1, k+2, k+3};
+    template_indices_.insert(template_indices_.end(), tri, tri+6);
+  }
+
+  // head base: disk facing backwards
+  const Ogre::uint32 base_center = template_vertices_.size();
+  v.normal = Ogre::Vector3::NEGATIVE_UNIT_X;
+  v.position = Ogre::Vector3(SHAFT_LENGTH, 0, 0);
+  template_vertices_.push_back(v);
+  for (unsigned int i = 0; i <= SEGMENTS; ++i) {
+    const Ogre::Radian angle(Ogre::Math::TWO_PI * i / SEGMENTS);
+    v.position = Ogre::Vector3(SHAFT_LENGTH, HEAD_RADIUS * Ogre::Math::Cos(angle), HEAD_RADIUS * Ogre::Math::Sin(angle));
+    template_vertices_.push_back(v);
+  }
+  for (unsigned int i = 0; i < SEGMENTS; ++i) {
+    const Ogre::uint32 tri[] = {base_center, base_center+2+i, base_center+1+i};
+    template_indices_.insert(template_indices_.end(), tri, tri+3);
+  }
+
+  // head: cone towards tip
+  const Ogre::uint32 cone = template_vertices_.size();
+  const Ogre::Real slope = HEAD_RADIUS / HEAD_LENGTH;
+  for (unsigned int i = 0; i <= SEGMENTS; ++i) {
+    const Ogre::Radian angle(Ogre::Math::TWO_PI * i / SEGMENTS);
+    const Ogre::Real c = Ogre::Math::Cos(angle), s = Ogre::Math::Sin(angle);
+    v.normal = Ogre::Vector3(slope, c, s).normalisedCopy();
+    v.position = Ogre::Vector3(SHAFT_LENGTH, HEAD_RADIUS * c, HEAD_RADIUS * s);
+    template_vertices_.push_back(v);
+    v.position = Ogre::Vector3(SHAFT_LENGTH + HEAD_LENGTH, 0, 0);
+    template_vertices_.push_back(v);
+  }
+  for (unsigned int i = 0; i < SEGMENTS; ++i) {
+    const Ogre::uint32 k = cone + 2*i;
+    const Ogre::uint32 tri[] = {k, k+2, k+1};
+    template_indices_.insert(template_indices_.end(), tri, tri+3);
+  }
+}
+
+void ArrowBatch::add(const Ogre::Vector3 &position, const Ogre::Vector3 &direction,
+                     Ogre::Real length, Ogre::Real width, Ogre::uint32 abgr)
+{
+  if (length <= 0 || direction.isZeroLength()) return;
+
+  Instance instance;
+  instance.position = position;
+  instance.orientation = Ogre::Vector3::UNIT_X.getRotationTo(direction);
+  instance.scale = Ogre::Vector3(length, width, width);
+  instance.color = abgr;
+  instances_.push_back(instance);
+}
+
+void ArrowBatch::reserve(size_t capacity)
+{
+  if (capacity <= capacity_) return;
+  capacity_ = std::max<size_t>(16, capacity_);
+  while (capacity_ < capacity) capacity_ *= 2;
+
+  Ogre::HardwareBufferManager &manager = Ogre::HardwareBufferManager::getSingleton();
+  const size_t num_vertices = capacity_ * template_vertices_.size();
+  vertex_buffer_ = manager.createVertexBuffer
+      (mRenderOp.vertexData->vertexDeclaration->getVertexSize(0), num_vertices,
+       Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+  mRenderOp.vertexData->vertexBufferBinding->setBinding(0, vertex_buffer_);
+
+  // indices only depend on number of instances
+  std::vector<Ogre::uint32> indices;
+  indices.reserve(capacity_ * template_indices_.size());
+  for (size_t i = 0; i < capacity_; ++i) {
+    const Ogre::uint32 offset = i * template_vertices_.size();
+    for (auto it = template_indices_.begin(), end = template_indices_.end(); it != end; ++it)
+      indices.push_back(*it + offset);
+  }
+  Ogre::HardwareIndexBufferSharedPtr index_buffer = manager.createIndexBuffer
+      (Ogre::HardwareIndexBuffer::IT_32BIT, indices.size(), Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+  index_buffer->writeData(0, index_buffer->getSizeInBytes(), &indices.front(), true);
+  mRenderOp.indexData->indexBuffer = index_buffer;
+}
+
+void ArrowBatch::update()
+{
+  mBox.setNull();
+  bounding_radius_ = 0;
+  mRenderOp.vertexData->vertexCount = instances_.size() * template_vertices_.size();
+  mRenderOp.indexData->indexCount = instances_.size() * template_indices_.size();
+  if (instances_.empty()) return;
+
+  reserve(instances_.size());
+  Vertex *out = static_cast<Vertex*>(vertex_buffer_->lock(Ogre::HardwareBuffer::HBL_DISCARD));
+
+  bool translucent = false;
+  Ogre::Real max_width = 0;
+  for (auto it = instances_.begin(), end = instances_.end(); it != end; ++it) {
+    const Ogre::Vector3 inv_scale(1.0 / it->scale.x, 1.0 / it->scale.y, 1.0 / it->scale.z);
+    for (auto v = template_vertices_.begin(), v_end = template_vertices_.end(); v != v_end; ++v, ++out) {
+      out->position = it->position + it->orientation * (it->scale * v->position);
+      out->normal = it->orientation * (inv_scale * v->normal).normalisedCopy();
+      out->color = it->color;
+    }
+    // bounds: arrow base and tip
+    const Ogre::Vector3 tip = it->position + it->orientation * Ogre::Vector3(it->scale.x * (SHAFT_LENGTH + HEAD_LENGTH), 0, 0);
+    mBox.merge(it->position);
+    mBox.merge(tip);
+    max_width = std::max(max_width, HEAD_RADIUS * it->scale.y);
+    translucent |= (it->color >> 24) < 0xFF;
+  }
+  vertex_buffer_->unlock();
+
+  // account for arrow width
+  mBox.setExtents(mBox.getMinimum() - max_width, mBox.getMaximum() + max_width);
+  bounding_radius_ = std::max(mBox.getMinimum().length(), mBox.getMaximum().length());
+  setTranslucent(translucent);
+}
+
+void ArrowBatch::setTranslucent(bool translucent)
+{
+  if (translucent == translucent_) return;
+  translucent_ = translucent;
+  setMaterial(cache_->vertexColorMaterial(translucent)->getName());
+}
+
+Ogre::Real ArrowBatch::getSquaredViewDepth(const Ogre::Camera *cam) const
+{
+  return getParentNode()->getSquaredViewDepth(cam);
+}
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "geometry_cache.h"
+#include <OgreSimpleRenderable.h>
+#include <OgreHardwareVertexBuffer.h>
+#include <vector>
+
+namespace rviz {
+namespace tactile {
+
+/** Batched rendering of many arrows with a single draw call.
+ *
+ *  All arrows share the same template geometry (with the proportions of rviz::Arrow),
+ *  which is instantiated per arrow on the CPU: each frame, arrows are collected via add()
+ *  and written into a single dynamic vertex buffer by update().
+ *  Indices only depend on the number of arrows and are rewritten only when capacity grows.
+ */
+class ArrowBatch : public Ogre::SimpleRenderable
+{
+public:
+  ArrowBatch();
+  ~ArrowBatch();
+
+  /// remove all arrows
+  void clear() {instances_.clear();}
+  /// add arrow pointing from position along direction (need not be normalized)
+  void add(const Ogre::Vector3 &position, const Ogre::Vector3 &direction,
+           Ogre::Real length, Ogre::Real width, Ogre::uint32 abgr);
+  /// write all arrows to hardware buffers
+  void update();
+  size_t size() const {return instances_.size();}
+
+  Ogre::Real getSquaredViewDepth(const Ogre::Camera *cam) const;
+  Ogre::Real getBoundingRadius() const {return bounding_radius_;}
+
+protected:
+  struct Vertex {
+    Ogre::Vector3 position;
+    Ogre::Vector3 normal;
+    Ogre::uint32 color;
+  };
+  struct Instance {
+    Ogre::Vector3 position;
+    Ogre::Quaternion orientation;
+    Ogre::Vector3 scale;
+    Ogre::uint32 color;
+  };
+
+  void createTemplate();
+  void reserve(size_t capacity);
+  void setTranslucent(bool translucent);
+
+  std::vector<Vertex> template_vertices_;  /// arrow of unit length along x-axis
+  std::vector<Ogre::uint32> template_indices_;
+  std::vector<Instance> instances_;
+  size_t capacity_;  /// number of arrows fitting into hardware buffers
+
+  Ogre::HardwareVertexBufferSharedPtr vertex_buffer_;
+  GeometryCachePtr cache_;  /// shared vertex color materials
+  Ogre::Real bounding_radius_;
+  bool translucent_;
+};
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,132 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include "color_lut.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace rviz {
+namespace tactile {
+
+const unsigned int ColorLUT::RESOLUTION;
+const unsigned int ColorLUT::INVALID;
+
+ColorLUT::ColorLUT(float fMin, float fMax)
+	: lut(RESOLUTION+1, 0)
+{
+	setRange(fMin, fMax);
+	setInvalidColor(pack(255, 0, 255));  // magenta
+}
+
+void ColorLUT::setRange(float fMin, float fMax)
+{
+	// lookup table is indexed by normalized values, thus independent of input range
+	if (!(fMax > fMin)) fMax = fMin + std::numeric_limits<float>::epsilon() * std::max(1.f, std::abs(fMin));
+	this->fMin = fMin;
+	this->fMax = fMax;
+	this->scale = (RESOLUTION-1) / (fMax-fMin);
+}
+
+void ColorLUT::setColors(const std::vector<uint32_t> &stops)
+{
+	this->stops = stops;
+	updateLUT();
+}
+
+void ColorLUT::setInvalidColor(uint32_t rgba)
+{
+	lut[INVALID] = rgba;
+}
+
+uint32_t ColorLUT::pack(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	uint32_t result;
+	uint8_t *bytes = reinterpret_cast<uint8_t*>(&result);
+	bytes[0] = r;
+	bytes[1] = g;
+	bytes[2] = b;
+	bytes[3] = a;
+	return result;
+}
+
+void ColorLUT::updateLUT()
+{
+	if (stops.size() < 2) return; // not yet fully initialized
+
+	const size_t last = stops.size()-1;
+	for (unsigned int i = 0; i < RESOLUTION; ++i) {
+		// linear interpolation between neighboring color stops (per byte)
+		float ratio = float(i) / (RESOLUTION-1) * last;
+		size_t idx = std::min(static_cast<size_t>(ratio), last-1);
+		float b = ratio - idx;
+		float a = 1.0 - b;
+		const uint8_t *lo = reinterpret_cast<const uint8_t*>(&stops[idx]);
+		const uint8_t *hi = reinterpret_cast<const uint8_t*>(&stops[idx+1]);
+		uint8_t *out = reinterpret_cast<uint8_t*>(&lut[i]);
+		for (int c = 0; c < 4; ++c)
+			out[c] = static_cast<uint8_t>(a*lo[c] + b*hi[c]);
+	}
+}
+
+// quantization shared by all index() and map() variants
+// Written branch-free to allow auto-vectorization of the batch loops.
+static inline unsigned int quantize(float value, float fMin, float scale)
+{
+	float ratio = (value-fMin) * scale;
+	ratio = std::min(std::max(ratio, 0.f), float(ColorLUT::RESOLUTION-1));
+	// value-value is zero for finite values only (NaN otherwise)
+	return (value-value == 0.f) ? static_cast<unsigned int>(ratio + 0.5f) : ColorLUT::INVALID;
+}
+
+unsigned int ColorLUT::index(float value) const
+{
+	return quantize(value, fMin, scale);
+}
+
+void ColorLUT::index(const float *begin, const float *end, unsigned int *out) const
+{
+	const float fMin = this->fMin, scale = this->scale;
+	for (; begin != end; ++begin, ++out)
+		*out = quantize(*begin, fMin, scale);
+}
+
+void ColorLUT::map(const float *begin, const float *end, uint32_t *out) const
+{
+	// process in chunks: quantize (vectorized), then lookup
+	static const size_t CHUNK = 256;
+	unsigned int indices[CHUNK];
+	const uint32_t *table = &lut.front();
+	while (begin != end) {
+		size_t n = std::min<size_t>(CHUNK, end - begin);
+		index(begin, begin + n, indices);
+		for (size_t i = 0; i < n; ++i)
+			out[i] = table[indices[i]];
+		begin += n;
+		out += n;
+	}
+}
+
+}
+}
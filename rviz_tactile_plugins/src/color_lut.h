@@ -0,0 +1,88 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace rviz {
+namespace tactile {
+
+/** Lookup table mapping scalar values onto packed colors.
+ *
+ *  Plain C++ core of ColorMap (without any Qt dependency):
+ *  values are linearly quantized from [min, max] into RESOLUTION color indices,
+ *  which index a table of colors interpolated between evenly spaced color stops.
+ */
+class ColorLUT
+{
+public:
+	ColorLUT(float fMin=0, float fMax=1);
+
+	/// change input range, keeping colors (and thus the lookup table)
+	void setRange(float fMin, float fMax);
+	float min() const {return fMin;}
+	float max() const {return fMax;}
+
+	/// set (packed) colors, evenly spaced across the range
+	void setColors(const std::vector<uint32_t> &stops);
+	const std::vector<uint32_t> &colors() const {return stops;}
+	/// set (packed) color used for non-finite values
+	void setInvalidColor(uint32_t rgba);
+
+	/// number of quantization levels of index()
+	static const unsigned int RESOLUTION = 1024;
+	/// index returned for non-finite values
+	static const unsigned int INVALID = RESOLUTION;
+
+	/// quantize a value into a color index in 0..RESOLUTION-1 (or INVALID)
+	unsigned int index(float value) const;
+	/// quantize all values of range [begin, end) into color indices
+	void index(const float *begin, const float *end, unsigned int *out) const;
+
+	/** packed color of a quantized color index
+	 *
+	 *  Colors are packed as bytes R,G,B,A in memory, i.e. as ABGR on little-endian machines,
+	 *  matching Ogre::VET_COLOUR_ABGR and Ogre::PF_BYTE_RGBA.
+	 */
+	uint32_t rgba(unsigned int index) const {return lut[index];}
+	/// map all values of range [begin, end) onto packed colors
+	void map(const float *begin, const float *end, uint32_t *out) const;
+
+	static uint32_t pack(uint8_t r, uint8_t g, uint8_t b, uint8_t a=255);
+
+private:
+	void updateLUT();
+
+private:
+	std::vector<uint32_t> stops; /// packed colors, evenly spaced from fMin..fMax
+	float fMin, fMax;
+	float scale; /// (RESOLUTION-1) / (fMax-fMin)
+	std::vector<uint32_t> lut; /// RESOLUTION+1 packed colors, last one for INVALID
+};
+
+}
+}
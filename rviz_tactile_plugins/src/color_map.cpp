@@ -30,31 +30,53 @@ namespace rviz {
 namespace tactile {
 
 ColorMap::ColorMap(float fMin, float fMax)
+	: ColorLUT(fMin, fMax)
 {
-	init(fMin, fMax);
+	setInvalidColor(QColor("magenta"));
 }
 
 void ColorMap::init(float fMin, float fMax)
 {
 	this->colors.clear();
-	this->fMin = fMin;
-	this->fMax = fMax;
+	setRange(fMin, fMax);
+	updateLUT();
 }
 
 void ColorMap::append(const QColor &c)
 {
 	colors.append(c);
+	updateLUT();
 }
 
 void ColorMap::append(const QList<QColor> &cols)
 {
 	colors += cols;
+	updateLUT();
 }
 
 void ColorMap::append(const QStringList &names)
 {
 	for (QStringList::const_iterator it=names.begin(), end=names.end(); it!=end; ++it)
 		colors.append(QColor(*it));
+	updateLUT();
+}
+
+void ColorMap::setInvalidColor(const QColor &c)
+{
+	ColorLUT::setInvalidColor(pack(c));
+}
+
+uint32_t ColorMap::pack(const QColor &c)
+{
+	return ColorLUT::pack(c.red(), c.green(), c.blue(), c.alpha());
+}
+
+void ColorMap::updateLUT()
+{
+	std::vector<uint32_t> stops;
+	for (QList<QColor>::const_iterator it=colors.begin(), end=colors.end(); it!=end; ++it)
+		stops.push_back(pack(*it));
+	setColors(stops);
 }
 
 QColor ColorMap::map(float value) const
@@ -63,7 +85,7 @@ QColor ColorMap::map(float value) const
 	assert(colors.size() > 1);
 	if (std::isnan(value)) return errColor;
 
-	float ratio = (value-fMin) / (fMax-fMin) * (colors.size()-1);
+	float ratio = (value-min()) / (max()-min()) * (colors.size()-1);
 	if (ratio < 0) return colors[0];
 	int   idx = ratio;
 	if (idx >= colors.size()-1) return colors.last();
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "color_lut.h"
 #include <QColor>
 #include <QList>
 #include <QStringList>
@@ -31,7 +32,8 @@
 namespace rviz {
 namespace tactile {
 
-class ColorMap
+/// ColorLUT defined by a list of QColors
+class ColorMap : public ColorLUT
 {
 public:
 	ColorMap(float fMin=0, float fMax=1);
@@ -40,13 +42,20 @@ public:
 	void append(const QColor &c);
 	void append(const QList<QColor> &cols);
 	void append(const QStringList &names);
+	/// color used for non-finite values in the lookup table
+	void setInvalidColor(const QColor &c);
 
 	/// map a value linearly onto the color map (assuming an input range from min..max)
 	QColor map(float value) const;
+	using ColorLUT::map;
+
+	static uint32_t pack(const QColor &c);
+
+private:
+	void updateLUT();
 
 private:
 	QList<QColor> colors;
-	float fMin, fMax;
 };
 
 }
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "geometry_cache.h"
+
+#include <rviz/mesh_loader.h>
+#include <ros/console.h>
+
+#include <OgreMesh.h>
+#include <OgreSubMesh.h>
+#include <OgreMeshManager.h>
+#include <OgreMaterialManager.h>
+#include <OgreTechnique.h>
+#include <boost/weak_ptr.hpp>
+
+#include <sstream>
+#include <iomanip>
+
+namespace rviz {
+namespace tactile {
+
+bool getTaxelShape(const urdf::Geometry &geom, TaxelShape &shape)
+{
+  shape.orientation = Ogre::Quaternion::IDENTITY;
+  switch (geom.type)
+  {
+  case urdf::Geometry::SPHERE:
+  {
+    const urdf::Sphere& sphere = static_cast<const urdf::Sphere&>(geom);
+    shape.mesh = "rviz_sphere.mesh";
+    shape.scale = Ogre::Vector3(sphere.radius*2, sphere.radius*2, sphere.radius*2);
+    return true;
+  }
+  case urdf::Geometry::BOX:
+  {
+    const urdf::Box& box = static_cast<const urdf::Box&>(geom);
+    shape.mesh = "rviz_cube.mesh";
+    shape.scale = Ogre::Vector3(box.dim.x, box.dim.y, box.dim.z);
+    return true;
+  }
+  case urdf::Geometry::CYLINDER:
+  {
+    const urdf::Cylinder& cylinder = static_cast<const urdf::Cylinder&>(geom);
+    shape.mesh = "rviz_cylinder.mesh";
+    shape.orientation.FromAngleAxis(Ogre::Degree(90), Ogre::Vector3::UNIT_X);
+    shape.scale = Ogre::Vector3(cylinder.radius*2, cylinder.length, cylinder.radius*2);
+    return true;
+  }
+  case urdf::Geometry::MESH:
+  {
+    const urdf::Mesh& mesh = static_cast<const urdf::Mesh&>(geom);
+    if (mesh.filename.empty()) return false;
+    shape.mesh = mesh.filename;
+    shape.scale = Ogre::Vector3(mesh.scale.x, mesh.scale.y, mesh.scale.z);
+    return true;
+  }
+  default:
+    ROS_WARN("Unsupported geometry type for element: %d", geom.type);
+    return false;
+  }
+}
+
+
+boost::shared_ptr<GeometryCache> GeometryCache::instance()
+{
+  // only accessed from rviz' main thread
+  static boost::weak_ptr<GeometryCache> weak;
+
+  boost::shared_ptr<GeometryCache> cache = weak.lock();
+  if (!cache) {
+    cache.reset(new GeometryCache());
+    weak = cache;
+  }
+  return cache;
+}
+
+GeometryCache::~GeometryCache()
+{
+  Ogre::MaterialManager &manager = Ogre::MaterialManager::getSingleton();
+  for (auto it = color_materials_.begin(), end = color_materials_.end(); it != end; ++it)
+    manager.remove(it->second->getName());
+  for (unsigned int i = 0; i < 2; ++i)
+    if (!vertex_color_materials_[i].isNull())
+      manager.remove(vertex_color_materials_[i]->getName());
+}
+
+Ogre::MeshPtr GeometryCache::mesh(const std::string &name)
+{
+  if (name.compare(0, 5, "rviz_") == 0)  // rviz' primitive shapes
+    return Ogre::MeshManager::getSingleton().load(name, Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+  else
+    return loadMeshFromResource(name);
+}
+
+const GeometryCache::Geometry &GeometryCache::geometry(const std::string &name)
+{
+  auto it = geometries_.find(name);
+  if (it != geometries_.end())
+    return it->second;
+
+  Geometry &geometry = geometries_[name];
+  Ogre::MeshPtr mesh = GeometryCache::mesh(name);
+  if (mesh.isNull()) return geometry;
+
+  bool shared_added = false;
+  size_t shared_offset = 0;
+  for (unsigned short i = 0, end = mesh->getNumSubMeshes(); i < end; ++i)
+  {
+    const Ogre::SubMesh *submesh = mesh->getSubMesh(i);
+    size_t offset = geometry.vertices.size();
+    if (submesh->useSharedVertices) {
+      if (!shared_added) {
+        shared_offset = offset;
+        shared_added = true;
+        extractVertices(mesh->sharedVertexData, geometry);
+      }
+      offset = shared_offset;
+    } else {
+      extractVertices(submesh->vertexData, geometry);
+    }
+    extractIndices(submesh->indexData, offset, geometry);
+  }
+  return geometry;
+}
+
+void GeometryCache::extractVertices(const Ogre::VertexData *vertex_data, Geometry &geometry)
+{
+  const Ogre::VertexElement *pos_elem =
+      vertex_data->vertexDeclaration->findElementBySemantic(Ogre::VES_POSITION);
+  const Ogre::VertexElement *normal_elem =
+      vertex_data->vertexDeclaration->findElementBySemantic(Ogre::VES_NORMAL);
+
+  Ogre::HardwareVertexBufferSharedPtr pos_buf =
+      vertex_data->vertexBufferBinding->getBuffer(pos_elem->getSource());
+  unsigned char *pos_data = static_cast<unsigned char*>
+      (pos_buf->lock(Ogre::HardwareBuffer::HBL_READ_ONLY));
+
+  Ogre::HardwareVertexBufferSharedPtr normal_buf;
+  unsigned char *normal_data = 0;
+  if (normal_elem) {
+    if (normal_elem->getSource() == pos_elem->getSource()) {
+      normal_buf = pos_buf;
+      normal_data = pos_data;
+    } else {
+      normal_buf = vertex_data->vertexBufferBinding->getBuffer(normal_elem->getSource());
+      normal_data = static_cast<unsigned char*>(normal_buf->lock(Ogre::HardwareBuffer::HBL_READ_ONLY));
+    }
+  }
+
+  const size_t start = vertex_data->vertexStart;
+  for (size_t j = start, end = start + vertex_data->vertexCount; j < end; ++j)
+  {
+    float *p;
+    pos_elem->baseVertexPointerToElement(pos_data + j * pos_buf->getVertexSize(), &p);
+
+    Vertex v;
+    v.position = Ogre::Vector3(p[0], p[1], p[2]);
+    if (normal_data) {
+      float *n;
+      normal_elem->baseVertexPointerToElement(normal_data + j * normal_buf->getVertexSize(), &n);
+      v.normal = Ogre::Vector3(n[0], n[1], n[2]);
+    } else {
+      v.normal = Ogre::Vector3::UNIT_Z;
+    }
+    geometry.vertices.push_back(v);
+  }
+
+  pos_buf->unlock();
+  if (normal_data && normal_data != pos_data)
+    normal_buf->unlock();
+}
+
+void GeometryCache::extractIndices(const Ogre::IndexData *index_data, Ogre::uint32 offset, Geometry &geometry)
+{
+  Ogre::HardwareIndexBufferSharedPtr ibuf = index_data->indexBuffer;
+  const bool use32bit = (ibuf->getType() == Ogre::HardwareIndexBuffer::IT_32BIT);
+  void *data = ibuf->lock(Ogre::HardwareBuffer::HBL_READ_ONLY);
+
+  const size_t start = index_data->indexStart;
+  const size_t end = start + index_data->indexCount;
+  if (use32bit) {
+    const Ogre::uint32 *idx = static_cast<const Ogre::uint32*>(data);
+    for (size_t k = start; k < end; ++k)
+      geometry.indices.push_back(idx[k] + offset);
+  } else {
+    const Ogre::uint16 *idx = static_cast<const Ogre::uint16*>(data);
+    for (size_t k = start; k < end; ++k)
+      geometry.indices.push_back(static_cast<Ogre::uint32>(idx[k]) + offset);
+  }
+  ibuf->unlock();
+}
+
+static inline bool isTranslucent(Ogre::uint32 abgr) {
+  return (abgr >> 24) < 0xFF;
+}
+
+static void setTranslucent(const Ogre::MaterialPtr &material, bool translucent)
+{
+  Ogre::Technique* technique = material->getTechnique(0);
+  technique->setSceneBlending(translucent ? Ogre::SBT_TRANSPARENT_ALPHA : Ogre::SBT_REPLACE);
+  technique->setDepthWriteEnabled(!translucent);
+}
+
+const Ogre::MaterialPtr &GeometryCache::colorMaterial(Ogre::uint32 abgr)
+{
+  Ogre::MaterialPtr &material = color_materials_[abgr];
+  if (!material.isNull())
+    return material;
+
+  std::stringstream ss;
+  ss << "taxel color material " << std::hex << std::setw(8) << std::setfill('0') << abgr;
+  material = Ogre::MaterialManager::getSingleton().create(ss.str(), Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  material->setReceiveShadows(false);
+
+  Ogre::ColourValue c;
+  c.setAsABGR(abgr);
+  Ogre::Technique* technique = material->getTechnique(0);
+  technique->setAmbient(c.r*0.5, c.g*0.5, c.b*0.5);
+  technique->setDiffuse(c.r, c.g, c.b, c.a);
+  technique->setLightingEnabled(true);
+  setTranslucent(material, isTranslucent(abgr));
+  return material;
+}
+
+const Ogre::MaterialPtr &GeometryCache::vertexColorMaterial(bool translucent)
+{
+  Ogre::MaterialPtr &material = vertex_color_materials_[translucent];
+  if (!material.isNull())
+    return material;
+
+  material = Ogre::MaterialManager::getSingleton().create
+      (translucent ? "taxels translucent vertex color material" : "taxels vertex color material",
+       Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  material->setReceiveShadows(false);
+
+  Ogre::Pass *pass = material->getTechnique(0)->getPass(0);
+  pass->setLightingEnabled(true);
+  // colors are taken from the per-vertex color buffer
+  pass->setVertexColourTracking(Ogre::TVC_AMBIENT | Ogre::TVC_DIFFUSE);
+  setTranslucent(material, translucent);
+  return material;
+}
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <urdf_model/link.h>
+#include <OgreVector3.h>
+#include <OgreQuaternion.h>
+#include <OgreMaterial.h>
+#include <OgreMesh.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <vector>
+#include <string>
+
+namespace rviz {
+namespace tactile {
+
+/// Ogre mesh resource with scaling and orientation offset representing a urdf::Geometry
+struct TaxelShape {
+  std::string mesh;
+  Ogre::Vector3 scale;
+  Ogre::Quaternion orientation;
+};
+/// resolve the TaxelShape of a geometry, returns false if geometry is not supported
+bool getTaxelShape(const urdf::Geometry &geometry, TaxelShape &shape);
+
+/** Resources shared by all taxels visuals: geometry data and materials.
+ *
+ *  Vertex data of a mesh is extracted from Ogre's hardware buffers only once per mesh
+ *  and materials are shared by all taxels of the same color. Thus creating sensors
+ *  scales with the number of distinct shapes and colors, not with the number of taxels.
+ */
+class GeometryCache
+{
+public:
+  struct Vertex {
+    Ogre::Vector3 position;
+    Ogre::Vector3 normal;
+  };
+  struct Geometry {
+    std::vector<Vertex> vertices;
+    std::vector<Ogre::uint32> indices;  /// triangle list
+  };
+
+  /// cache shared by all visuals, kept alive as long as any user holds it
+  static boost::shared_ptr<GeometryCache> instance();
+  ~GeometryCache();
+
+  /// load mesh resource (rviz primitive or mesh file)
+  static Ogre::MeshPtr mesh(const std::string &name);
+  /// (cached) vertex and index data of the given mesh resource, empty if loading failed
+  const Geometry &geometry(const std::string &mesh);
+  /// (cached) lit material of given (packed ABGR) color
+  const Ogre::MaterialPtr &colorMaterial(Ogre::uint32 abgr);
+  /// (cached) lit material using per-vertex colors
+  const Ogre::MaterialPtr &vertexColorMaterial(bool translucent);
+
+private:
+  GeometryCache() {}
+  void extractVertices(const Ogre::VertexData *vertex_data, Geometry &geometry);
+  void extractIndices(const Ogre::IndexData *index_data, Ogre::uint32 offset, Geometry &geometry);
+
+  boost::unordered_map<std::string, Geometry> geometries_;
+  boost::unordered_map<Ogre::uint32, Ogre::MaterialPtr> color_materials_;
+  Ogre::MaterialPtr vertex_color_materials_[2];
+};
+typedef boost::shared_ptr<GeometryCache> GeometryCachePtr;
+
+} // namespace tactile
+} // namespace rviz
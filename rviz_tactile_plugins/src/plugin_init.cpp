@@ -1,6 +1,10 @@
 #include <pluginlib/class_list_macros.h>
 #include "tactile_state_display.h"
 #include "tactile_contact_display.h"
+#include "taxel_selection_tool.h"
+#include "tactile_array_panel.h"
 
 PLUGINLIB_EXPORT_CLASS(rviz::tactile::TactileStateDisplay, rviz::Display);
 PLUGINLIB_EXPORT_CLASS(rviz::tactile::TactileContactDisplay, rviz::Display);
+PLUGINLIB_EXPORT_CLASS(rviz::tactile::TaxelSelectionTool, rviz::Tool);
+PLUGINLIB_EXPORT_CLASS(rviz::tactile::TactileArrayPanel, rviz::Panel);
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+namespace rviz {
+namespace tactile {
+
+/** Throttle periodic actions to a given period, driven by the (wall) time passed between frames.
+ *
+ *  Different phases allow to stagger the actions of several limiters with the same period
+ *  across frames, avoiding load peaks in a single frame.
+ */
+class RateLimiter
+{
+public:
+  RateLimiter() : phase_(0), elapsed_(0) {}
+
+  /// set phase in [0,1) as a fraction of the period
+  void setPhase(float phase) {phase_ = phase; elapsed_ = -1;}
+
+  /// advance time by dt, returns true if the action is due (always true for period <= 0)
+  bool tick(float dt, float period) {
+    if (period <= 0) return true;
+    if (elapsed_ < 0) elapsed_ = phase_ * period;  // (re)initialize
+    elapsed_ += dt;
+    if (elapsed_ < period) return false;
+    elapsed_ -= period;
+    // don't try to catch up after a long pause
+    if (elapsed_ >= period) elapsed_ = 0;
+    return true;
+  }
+
+private:
+  float phase_;
+  float elapsed_;  /// time elapsed since action was due last
+};
+
+} // namespace tactile
+} // namespace rviz
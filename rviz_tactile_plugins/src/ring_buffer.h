@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace rviz {
+namespace tactile {
+
+/** Fixed-capacity FIFO, overwriting the oldest element when full.
+ *
+ *  Storage is allocated once by setCapacity(), push() and pop() never allocate.
+ *  Elements are indexed from oldest (0) to newest (size()-1).
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+  explicit RingBuffer(size_t capacity = 0) : begin_(0), size_(0) {setCapacity(capacity);}
+
+  /// (re)allocate storage, discarding all elements
+  void setCapacity(size_t capacity) {data_.resize(capacity); clear();}
+  size_t capacity() const {return data_.size();}
+  size_t size() const {return size_;}
+  bool empty() const {return size_ == 0;}
+  bool full() const {return size_ == data_.size();}
+  void clear() {begin_ = size_ = 0;}
+
+  /// append new element, dropping the oldest one if full (returns false in this case)
+  bool push(const T &value) {
+    if (data_.empty()) return false;
+    if (full()) {
+      data_[begin_] = value;
+      begin_ = next(begin_);
+      return false;
+    }
+    data_[index(size_++)] = value;
+    return true;
+  }
+  /// remove oldest element
+  void pop() {begin_ = next(begin_); --size_;}
+
+  T &operator[](size_t i) {return data_[index(i)];}
+  const T &operator[](size_t i) const {return data_[index(i)];}
+  const T &front() const {return data_[begin_];}
+  const T &back() const {return data_[index(size_ - 1)];}
+
+private:
+  size_t next(size_t i) const {return ++i == data_.size() ? 0 : i;}
+  size_t index(size_t i) const {i += begin_; return i >= data_.size() ? i - data_.size() : i;}
+
+  std::vector<T> data_;
+  size_t begin_;  /// index of oldest element
+  size_t size_;
+};
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "tactile_array_panel.h"
+
+#include <urdf/sensor.h>
+#include <urdf_tactile/tactile.h>
+#include <urdf_tactile/cast.h>
+#include <rviz/config.h>
+
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QListWidget>
+#include <QPushButton>
+#include <QFormLayout>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QTimer>
+
+#include <limits>
+#include <cmath>
+
+namespace rviz {
+namespace tactile {
+
+/// widget painting the images of all selected heatmaps in a grid
+class HeatmapView : public QWidget
+{
+public:
+  HeatmapView(const std::vector<TactileArrayPanel::Heatmap> &heatmaps, QWidget *parent = 0)
+    : QWidget(parent), heatmaps_(heatmaps)
+  {
+    setMinimumSize(100, 100);
+  }
+
+protected:
+  void paintEvent(QPaintEvent *);
+
+  const std::vector<TactileArrayPanel::Heatmap> &heatmaps_;
+};
+
+void HeatmapView::paintEvent(QPaintEvent *)
+{
+  QPainter painter(this);
+  std::vector<const TactileArrayPanel::Heatmap*> shown;
+  for (auto it = heatmaps_.begin(), end = heatmaps_.end(); it != end; ++it)
+    if (it->selected) shown.push_back(&*it);
+  if (shown.empty()) {
+    painter.drawText(rect(), Qt::AlignCenter, "no tactile arrays selected");
+    return;
+  }
+
+  // arrange heatmaps in a (nearly) square grid
+  const int columns = std::ceil(std::sqrt(float(shown.size())));
+  const int rows = (shown.size() + columns - 1) / columns;
+  const qreal cell_width = qreal(width()) / columns, cell_height = qreal(height()) / rows;
+  const int label_height = fontMetrics().height();
+
+  for (size_t i = 0; i < shown.size(); ++i) {
+    const TactileArrayPanel::Heatmap &heatmap = *shown[i];
+    const QRectF cell = QRectF((i % columns) * cell_width, (i / columns) * cell_height,
+                               cell_width, cell_height).adjusted(2, 2, -2, -2);
+    painter.drawText(cell, Qt::AlignHCenter | Qt::AlignTop, QString::fromStdString(heatmap.name));
+
+    // fit array into remaining area, preserving its aspect ratio
+    const QRectF area = cell.adjusted(0, label_height, 0, 0);
+    if (area.width() <= 0 || area.height() <= 0) continue;
+    QSizeF size(area.width(), area.width() / heatmap.aspect);
+    if (size.height() > area.height())
+      size = QSizeF(area.height() * heatmap.aspect, area.height());
+
+    painter.save();
+    painter.translate(area.center().x() - 0.5 * size.width(), area.center().y() - 0.5 * size.height());
+    painter.scale(size.width() / heatmap.cols, size.height() / heatmap.rows);
+    if (!heatmap.row_major)  // image holds columns as rows
+      painter.setWorldTransform(QTransform(0, 1, 1, 0, 0, 0), true);
+    painter.drawImage(QPointF(0, 0), heatmap.image);  // no smoothing: one block per taxel
+    painter.restore();
+  }
+}
+
+
+TactileArrayPanel::TactileArrayPanel(QWidget *parent)
+  : rviz::Panel(parent)
+{
+  topic_edit_ = new QLineEdit("/tactile_states");
+  robot_description_edit_ = new QLineEdit("robot_description");
+  rate_spin_ = new QSpinBox();
+  rate_spin_->setRange(1, 100);
+  rate_spin_->setValue(20);
+  rate_spin_->setSuffix(" Hz");
+  channel_list_ = new QListWidget();
+  channel_list_->setMaximumHeight(80);
+  QPushButton *reset_button = new QPushButton("Reset");
+  reset_button->setToolTip("reset value ranges of all sensors");
+  view_ = new HeatmapView(heatmaps_);
+
+  QFormLayout *form = new QFormLayout();
+  form->addRow("Topic:", topic_edit_);
+  form->addRow("Robot Description:", robot_description_edit_);
+  form->addRow("Refresh rate:", rate_spin_);
+  QHBoxLayout *channels = new QHBoxLayout();
+  channels->addWidget(channel_list_);
+  channels->addWidget(reset_button, 0, Qt::AlignTop);
+  QVBoxLayout *layout = new QVBoxLayout();
+  layout->addLayout(form);
+  layout->addLayout(channels);
+  layout->addWidget(view_, 1);
+  setLayout(layout);
+
+  QStringList colorNames;
+  colorNames << "black" << "lime" << "yellow" << "red";
+  color_map_.append(colorNames);
+
+  timer_ = new QTimer(this);
+  onRateChanged();
+
+  connect(topic_edit_, SIGNAL(editingFinished()), this, SLOT(onTopicChanged()));
+  connect(robot_description_edit_, SIGNAL(editingFinished()), this, SLOT(onRobotDescriptionChanged()));
+  connect(rate_spin_, SIGNAL(valueChanged(int)), this, SLOT(onRateChanged()));
+  connect(channel_list_, SIGNAL(itemChanged(QListWidgetItem*)), this, SLOT(onChannelChanged(QListWidgetItem*)));
+  connect(reset_button, SIGNAL(clicked()), this, SLOT(resetRanges()));
+  connect(timer_, SIGNAL(timeout()), this, SLOT(onTimer()));
+
+  onRobotDescriptionChanged();
+  timer_->start();
+}
+
+void TactileArrayPanel::load(const rviz::Config &config)
+{
+  rviz::Panel::load(config);
+  QString text;
+  if (config.mapGetString("Topic", &text))
+    topic_edit_->setText(text);
+  if (config.mapGetString("Robot Description", &text))
+    robot_description_edit_->setText(text);
+  if (config.mapGetString("Hidden", &text))
+    deselected_ = text.split(';', QString::SkipEmptyParts);
+  int rate;
+  if (config.mapGetInt("Rate", &rate))
+    rate_spin_->setValue(rate);
+  onRobotDescriptionChanged();
+}
+
+void TactileArrayPanel::save(rviz::Config config) const
+{
+  rviz::Panel::save(config);
+  config.mapSetValue("Topic", topic_edit_->text());
+  config.mapSetValue("Robot Description", robot_description_edit_->text());
+  config.mapSetValue("Rate", rate_spin_->value());
+  config.mapSetValue("Hidden", deselected_.join(";"));
+}
+
+void TactileArrayPanel::subscribe()
+{
+  sub_.shutdown();
+  const std::string topic = topic_edit_->text().toStdString();
+  if (topic.empty() || heatmaps_.empty()) return;
+  try {
+    // callbacks are served from rviz' GUI thread, i.e. don't need locking
+    sub_ = nh_.subscribe(topic, 1, &TactileArrayPanel::processMessage, this);
+  } catch (const ros::Exception &e) {
+    ROS_ERROR_STREAM("failed to subscribe to " << topic << ": " << e.what());
+  }
+}
+
+void TactileArrayPanel::onTopicChanged()
+{
+  subscribe();
+  Q_EMIT configChanged();
+}
+
+void TactileArrayPanel::onRobotDescriptionChanged()
+{
+  heatmaps_.clear();
+  channel_list_->blockSignals(true);
+  channel_list_->clear();
+  try {
+    urdf::SensorMap sensors = urdf::parseSensorsFromParam(robot_description_edit_->text().toStdString(),
+                                                          urdf::getSensorParser("tactile"));
+    for (auto it = sensors.begin(), end = sensors.end(); it != end; ++it) {
+      urdf::tactile::TactileSensorConstSharedPtr sensor = urdf::tactile::tactile_sensor_cast(it->second);
+      if (!sensor || !sensor->array_) continue;  // only consider tactile arrays
+      const urdf::tactile::TactileArray &array = *sensor->array_;
+      if (array.rows == 0 || array.cols == 0) continue;
+
+      Heatmap heatmap;
+      heatmap.name = it->first;
+      heatmap.channel = sensor->channel_;
+      heatmap.rows = array.rows;
+      heatmap.cols = array.cols;
+      heatmap.row_major = (array.order == urdf::tactile::TactileArray::ROWMAJOR);
+      // physical extent: rows along x, cols along y
+      const double sx = std::abs(array.spacing.x != 0 ? array.spacing.x : array.size.x);
+      const double sy = std::abs(array.spacing.y != 0 ? array.spacing.y : array.size.y);
+      heatmap.aspect = (sx > 0 && sy > 0) ? (array.cols * sy) / (array.rows * sx) : float(array.cols) / array.rows;
+      heatmap.selected = !deselected_.contains(QString::fromStdString(heatmap.name));
+      heatmap.dirty = false;
+      heatmap.values.assign(array.rows * array.cols, 0);
+      heatmap.min = std::numeric_limits<float>::infinity();
+      heatmap.max = -std::numeric_limits<float>::infinity();
+      heatmap.color_map = color_map_;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+      const QImage::Format format = QImage::Format_RGBA8888;  // matches ColorMap's packing
+#else
+      const QImage::Format format = QImage::Format_ARGB32;  // needs R/B swapping
+#endif
+      if (heatmap.row_major)
+        heatmap.image = QImage(array.cols, array.rows, format);
+      else
+        heatmap.image = QImage(array.rows, array.cols, format);
+      heatmap.image.fill(0);
+      heatmaps_.push_back(heatmap);
+
+      QListWidgetItem *item = new QListWidgetItem(QString::fromStdString(heatmap.name), channel_list_);
+      item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+      item->setCheckState(heatmap.selected ? Qt::Checked : Qt::Unchecked);
+    }
+  } catch (const std::exception &e) {
+    ROS_ERROR_STREAM("failed to load tactile arrays from robot description: " << e.what());
+  }
+  channel_list_->blockSignals(false);
+  subscribe();
+  view_->update();
+}
+
+void TactileArrayPanel::onRateChanged()
+{
+  timer_->setInterval(1000 / rate_spin_->value());
+  Q_EMIT configChanged();
+}
+
+void TactileArrayPanel::onChannelChanged(QListWidgetItem *item)
+{
+  Heatmap &heatmap = heatmaps_[channel_list_->row(item)];
+  heatmap.selected = (item->checkState() == Qt::Checked);
+  deselected_.removeAll(item->text());
+  if (!heatmap.selected)
+    deselected_.append(item->text());
+  view_->update();
+  Q_EMIT configChanged();
+}
+
+void TactileArrayPanel::resetRanges()
+{
+  for (auto it = heatmaps_.begin(), end = heatmaps_.end(); it != end; ++it) {
+    it->min = std::numeric_limits<float>::infinity();
+    it->max = -std::numeric_limits<float>::infinity();
+  }
+}
+
+void TactileArrayPanel::processMessage(const tactile_msgs::TactileState::ConstPtr &msg)
+{
+  for (auto sensor = msg->sensors.begin(), end = msg->sensors.end(); sensor != end; ++sensor) {
+    for (auto it = heatmaps_.begin(), hend = heatmaps_.end(); it != hend; ++it) {
+      Heatmap &heatmap = *it;
+      if (heatmap.channel != sensor->name) continue;
+      if (sensor->values.size() != heatmap.values.size()) {
+        ROS_ERROR_STREAM_THROTTLE(1, "invalid number of taxels for " << heatmap.name);
+        continue;
+      }
+      // copy values, tracking their range
+      float *out = &heatmap.values.front();
+      for (auto v = sensor->values.begin(), vend = sensor->values.end(); v != vend; ++v, ++out) {
+        *out = *v;
+        if (*v < heatmap.min) heatmap.min = *v;
+        if (*v > heatmap.max) heatmap.max = *v;
+      }
+      heatmap.dirty = true;
+    }
+  }
+}
+
+void TactileArrayPanel::render(Heatmap &heatmap)
+{
+  if (heatmap.max >= heatmap.min)
+    heatmap.color_map.setRange(heatmap.min, heatmap.max);
+
+  // single pass: quantize values and look up packed colors directly into image pixels
+  const float *values = &heatmap.values.front();
+  heatmap.color_map.map(values, values + heatmap.values.size(),
+                        reinterpret_cast<uint32_t*>(heatmap.image.bits()));
+#if QT_VERSION < QT_VERSION_CHECK(5, 2, 0)
+  heatmap.image = heatmap.image.rgbSwapped();
+#endif
+  heatmap.dirty = false;
+}
+
+void TactileArrayPanel::onTimer()
+{
+  bool changed = false;
+  for (auto it = heatmaps_.begin(), end = heatmaps_.end(); it != end; ++it) {
+    if (!it->selected || !it->dirty) continue;
+    render(*it);
+    changed = true;
+  }
+  if (changed) view_->update();
+}
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <rviz/panel.h>
+#include <ros/ros.h>
+#include <tactile_msgs/TactileState.h>
+#include "color_map.h"
+
+#include <QImage>
+#include <vector>
+
+class QLineEdit;
+class QSpinBox;
+class QListWidget;
+class QListWidgetItem;
+class QTimer;
+
+namespace rviz {
+namespace tactile {
+
+class HeatmapView;
+
+/** Panel showing TactileArray sensors as 2D heatmaps.
+ *
+ *  Array sensors are read from the robot description. The latest readings of all selected
+ *  sensors are rendered at a configurable rate, mapping each channel's float buffer through
+ *  the ColorMap lookup table directly into the pixels of a QImage (one texel per taxel).
+ */
+class TactileArrayPanel : public rviz::Panel
+{
+  Q_OBJECT
+public:
+  TactileArrayPanel(QWidget *parent = 0);
+
+  void load(const rviz::Config &config);
+  void save(rviz::Config config) const;
+
+  struct Heatmap {
+    std::string name;     /// sensor name
+    std::string channel;  /// channel of sensor data
+    unsigned int rows, cols;
+    bool row_major;        /// data order, column-major images are shown transposed
+    float aspect;          /// physical width / height of array
+    bool selected;         /// shown in the panel?
+    bool dirty;            /// new data since last render?
+    std::vector<float> values;  /// latest readings
+    float min, max;       /// range of readings since last reset
+    ColorMap color_map;   /// copy of shared color map, scaled to [min, max]
+    QImage image;         /// rows x cols (cols x rows if column-major)
+  };
+  const std::vector<Heatmap> &heatmaps() const {return heatmaps_;}
+
+protected:
+  void subscribe();
+  void processMessage(const tactile_msgs::TactileState::ConstPtr &msg);
+  void render(Heatmap &heatmap);
+
+protected Q_SLOTS:
+  void onTopicChanged();
+  void onRobotDescriptionChanged();
+  void onRateChanged();
+  void onChannelChanged(QListWidgetItem *item);
+  void onTimer();
+  void resetRanges();
+
+protected:
+  QLineEdit *topic_edit_;
+  QLineEdit *robot_description_edit_;
+  QSpinBox *rate_spin_;
+  QListWidget *channel_list_;
+  HeatmapView *view_;
+  QTimer *timer_;
+
+  ros::NodeHandle nh_;
+  ros::Subscriber sub_;
+  ColorMap color_map_;
+  std::vector<Heatmap> heatmaps_;
+  QStringList deselected_;  /// names of sensors not shown
+};
+
+} // namespace tactile
+} // namespace rviz
@@ -32,65 +32,196 @@
 #include "tactile_array_visual.h"
 
 #include <rviz/config.h>
+#include <rviz/display_context.h>
 #include <ros/console.h>
 
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreManualObject.h>
+#include <OgreMaterialManager.h>
+#include <OgreTextureManager.h>
+#include <OgreTechnique.h>
+#include <OgreHardwarePixelBuffer.h>
+
+#include <sstream>
+
 using namespace urdf::tactile;
 
 namespace rviz {
 namespace tactile {
 
+/// center of cell of taxel idx (w.r.t. sensor frame)
+static Ogre::Vector3 cellCenter(const TactileArray &array, size_t idx)
+{
+  size_t row, col;
+  if (array.order == TactileArray::ROWMAJOR) {
+    row = idx / array.cols;
+    col = idx % array.cols;
+  } else {
+    row = idx % array.rows;
+    col = idx / array.rows;
+  }
+  return Ogre::Vector3(row * array.spacing.x - array.offset.x,
+                       col * array.spacing.y - array.offset.y, 0);
+}
+
+static inline bool isTranslucent(Ogre::uint32 abgr) {
+  return (abgr >> 24) < 0xFF;
+}
+
 TactileArrayVisual::TactileArrayVisual(const std::string &name, const std::string &frame, const urdf::Pose &origin,
                                        const TactileArraySharedPtr &array,
                                        rviz::Display *owner, DisplayContext *context,
-                                       Ogre::SceneNode *parent_node, rviz::Property *parent_property)
+                                       Ogre::SceneNode *parent_node, rviz::Property *parent_property,
+                                       Mode mode)
    : TactileVisualBase(name, frame, origin, owner, context, parent_node, parent_property)
+   , cloud_(0), quad_(0), num_translucent_(0), translucent_(true)
+{
+  pipeline_.init(array->rows * array->cols);
+  initSamples(pipeline_.size());
+  if (mode == BOXES)
+    createCloud(*array);
+  else
+    createTexture(*array, mode == SMOOTH_TEXTURE);
+  createBVH(*array);
+}
+
+TactileArrayVisual::~TactileArrayVisual()
+{
+  if (cloud_) {
+    scene_node_->detachObject(cloud_);
+    delete cloud_;
+  }
+  if (quad_) {
+    scene_node_->detachObject(quad_);
+    context_->getSceneManager()->destroyManualObject(quad_);
+    Ogre::MaterialManager::getSingleton().remove(material_->getName());
+    Ogre::TextureManager::getSingleton().remove(texture_->getName());
+  }
+}
+
+void TactileArrayVisual::createCloud(const TactileArray &array)
 {
   cloud_ = new rviz::PointCloud();
   scene_node_->attachObject(cloud_);
   cloud_->setRenderMode(rviz::PointCloud::RM_BOXES);
-  cloud_->setDimensions(array->size.x, array->size.y, 0.0f);
+  cloud_->setDimensions(array.size.x, array.size.y, 0.0f);
 
-  points_.resize(array->rows * array->cols);
-  values_.init(points_.size());
+  points_.resize(array.rows * array.cols);
 
   size_t idx = 0;
-  for (auto it = points_.begin(), end = points_.end(); it != end; ++it, ++idx) {
-    size_t row, col;
-    if (array->order == TactileArray::ROWMAJOR) {
-      row = idx / array->cols;
-      col = idx % array->cols;
-    } else {
-      row = idx % array->rows;
-      col = idx / array->rows;
-    }
-    it->position.x = row * array->spacing.x - array->offset.x;
-    it->position.y = col * array->spacing.y - array->offset.y;
-    it->position.z = 0;
+  for (auto it = points_.begin(), end = points_.end(); it != end; ++it, ++idx)
+    it->position = cellCenter(array, idx);
+}
+
+void TactileArrayVisual::createBVH(const TactileArray &array)
+{
+  // taxel cells are flat boxes of given size
+  const Ogre::Vector3 half(0.5 * array.size.x, 0.5 * array.size.y, 0);
+  std::vector<Ogre::Vector3> min(pipeline_.size()), max(pipeline_.size());
+  for (size_t idx = 0; idx < pipeline_.size(); ++idx) {
+    const Ogre::Vector3 center = cellCenter(array, idx);
+    min[idx] = max[idx] = center - half;
+    max[idx].makeCeil(center + half);
+    min[idx].makeFloor(center + half);  // size might be negative
   }
+  TaxelBVH *bvh = new TaxelBVH();
+  bvh->build(min, max);
+  bvh_.reset(bvh);
+}
+
+void TactileArrayVisual::createTexture(const TactileArray &array, bool smooth)
+{
+  static int count = 0;
+  std::stringstream ss;
+  ss << "tactile array " << count++;
+
+  // texture with one texel per taxel: texture rows (v) = array rows (x), texture cols (u) = array cols (y)
+  texels_.assign(array.rows * array.cols, 0);
+  num_translucent_ = texels_.size();  // initial color (0) is fully transparent
+  texel_index_.resize(texels_.size());
+  for (size_t idx = 0; idx < texel_index_.size(); ++idx) {
+    if (array.order == TactileArray::ROWMAJOR)
+      texel_index_[idx] = idx;
+    else // column-major data: row = idx % rows, col = idx / rows
+      texel_index_[idx] = (idx % array.rows) * array.cols + idx / array.rows;
+  }
+
+  texture_ = Ogre::TextureManager::getSingleton().createManual
+      (ss.str() + " texture", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, Ogre::TEX_TYPE_2D,
+       array.cols, array.rows, 0, Ogre::PF_BYTE_RGBA, Ogre::TU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+
+  material_ = Ogre::MaterialManager::getSingleton().create
+      (ss.str() + " material", Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  material_->setReceiveShadows(false);
+  Ogre::Pass *pass = material_->getTechnique(0)->getPass(0);
+  pass->setLightingEnabled(false);
+  pass->setCullingMode(Ogre::CULL_NONE);
+  pass->setSceneBlending(Ogre::SBT_TRANSPARENT_ALPHA);
+  pass->setDepthWriteEnabled(false);
+  Ogre::TextureUnitState *unit = pass->createTextureUnitState(texture_->getName());
+  unit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
+  unit->setTextureFiltering(smooth ? Ogre::TFO_BILINEAR : Ogre::TFO_NONE);
+
+  // quad covering all taxel cells (spacing might be negative to flip axes)
+  double sx = array.spacing.x != 0 ? array.spacing.x : array.size.x;
+  double sy = array.spacing.y != 0 ? array.spacing.y : array.size.y;
+  float x0 = -array.offset.x - 0.5 * sx, x1 = x0 + array.rows * sx;
+  float y0 = -array.offset.y - 0.5 * sy, y1 = y0 + array.cols * sy;
+
+  quad_ = context_->getSceneManager()->createManualObject();
+  quad_->begin(material_->getName(), Ogre::RenderOperation::OT_TRIANGLE_LIST);
+  quad_->position(x0, y0, 0); quad_->textureCoord(0, 0);
+  quad_->position(x1, y0, 0); quad_->textureCoord(0, 1);
+  quad_->position(x1, y1, 0); quad_->textureCoord(1, 1);
+  quad_->position(x0, y1, 0); quad_->textureCoord(1, 0);
+  quad_->quad(0, 1, 2, 3);
+  quad_->end();
+  scene_node_->attachObject(quad_);
+}
+
+void TactileArrayVisual::setTranslucent(bool translucent)
+{
+  if (translucent == translucent_) return;
+  translucent_ = translucent;
+
+  Ogre::Pass *pass = material_->getTechnique(0)->getPass(0);
+  pass->setSceneBlending(translucent ? Ogre::SBT_TRANSPARENT_ALPHA : Ogre::SBT_REPLACE);
+  pass->setDepthWriteEnabled(!translucent);
 }
 
 void TactileArrayVisual::update(const ros::Time &stamp,
                                 const sensor_msgs::ChannelFloat32::_values_type &values)
 {
-  if (values.size() == values_.size()) {
-    values_.updateValues(values);
-    TactileVisualBase::update(stamp);
+  if (values.size() == raw_values_.size()) {
+    std::copy(values.begin(), values.end(), raw_values_.begin());
+    publish(stamp);
   } else {
     ROS_ERROR_STREAM("invalid number of taxels for " << qPrintable(getName()));
   }
 }
 
-void TactileArrayVisual::update()
+void TactileArrayVisual::updateColors(const std::vector<unsigned int> &changed)
 {
-  auto p = points_.begin();
-  for (auto it = values_.begin(), end = values_.end(); it != end; ++it, ++p) {
-    const QColor &c = mapColor(mapValue(*it));
-    p->color.r = c.redF();
-    p->color.g = c.greenF();
-    p->color.b = c.blueF();
-    p->color.a = c.alphaF();
+  if (quad_) {
+    for (auto it = changed.begin(), end = changed.end(); it != end; ++it) {
+      Ogre::uint32 &texel = texels_[texel_index_[*it]];
+      const Ogre::uint32 color = mapColor(pipeline_.colorIndices()[*it]);
+      num_translucent_ += isTranslucent(color);
+      num_translucent_ -= isTranslucent(texel);
+      texel = color;
+    }
+    // single texture upload per frame
+    texture_->getBuffer()->blitFromMemory(Ogre::PixelBox(texture_->getWidth(), texture_->getHeight(), 1,
+                                                         Ogre::PF_BYTE_RGBA, &texels_.front()));
+    // fully opaque heatmaps are rendered in the opaque queue, writing depth
+    setTranslucent(num_translucent_ > 0);
+    return;
   }
 
+  for (auto it = changed.begin(), end = changed.end(); it != end; ++it)
+    points_[*it].color.setAsABGR(mapColor(pipeline_.colorIndices()[*it]));
+
   cloud_->clear();
   cloud_->addPoints(&points_.front(), points_.size());
 }
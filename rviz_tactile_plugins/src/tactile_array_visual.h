@@ -32,6 +32,13 @@
 #include "tactile_visual_base.h"
 #include <urdf_tactile/tactile.h>
 #include <rviz/ogre_helpers/point_cloud.h>
+#include <OgreTexture.h>
+#include <OgreMaterial.h>
+
+namespace Ogre
+{
+class ManualObject;
+}
 
 namespace rviz {
 namespace tactile {
@@ -39,18 +46,42 @@ namespace tactile {
 class TactileArrayVisual : public TactileVisualBase
 {
 public:
+  enum Mode {
+    BOXES,          /// render each taxel as a box of a point cloud
+    TEXTURE,        /// render array as a single quad, showing the taxels as a texture
+    SMOOTH_TEXTURE, /// as TEXTURE, but with bilinear texture filtering
+  };
+
   TactileArrayVisual(const std::string &name, const std::string &frame, const urdf::Pose &origin,
                      const urdf::tactile::TactileArraySharedPtr &array,
                      Display *owner, DisplayContext *context,
-                     Ogre::SceneNode* parent_node, rviz::Property *parent_property=0);
+                     Ogre::SceneNode* parent_node, rviz::Property *parent_property=0,
+                     Mode mode=BOXES);
+  ~TactileArrayVisual();
 
 protected:
   void update(const ros::Time &stamp, const sensor_msgs::ChannelFloat32::_values_type &values);
-  void update();
+  void updateColors(const std::vector<unsigned int> &changed);
+
+  void createCloud(const urdf::tactile::TactileArray &array);
+  void createTexture(const urdf::tactile::TactileArray &array, bool smooth);
+  void createBVH(const urdf::tactile::TactileArray &array);
+  /// switch quad material between alpha blending and opaque rendering (with depth write)
+  void setTranslucent(bool translucent);
 
 protected:
+  // BOXES mode
   rviz::PointCloud *cloud_;
   std::vector<rviz::PointCloud::Point> points_;
+
+  // TEXTURE mode
+  Ogre::ManualObject *quad_;
+  Ogre::TexturePtr texture_;
+  Ogre::MaterialPtr material_;
+  std::vector<Ogre::uint32> texels_;       /// texture image (ABGR), rows x cols
+  std::vector<unsigned int> texel_index_;  /// mapping taxel indices onto texels_
+  size_t num_translucent_;                 /// number of texels with alpha < 1
+  bool translucent_;
 };
 
 }
@@ -30,14 +30,22 @@
  */
 
 #include "tactile_contact_display.h"
+#include "arrow_batch.h"
 
 #include <rviz/visualization_manager.h>
 #include <rviz/frame_manager.h>
 #include <rviz/properties/float_property.h>
+#include <rviz/properties/int_property.h>
 #include <rviz/properties/color_property.h>
 #include <rviz/default_plugin/wrench_visual.h>
+#include <OgreBillboardChain.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreMaterialManager.h>
+#include <OgreTechnique.h>
 #include <QApplication>
 #include <boost/thread/locks.hpp>
+#include <sstream>
 
 namespace rviz {
 namespace tactile {
@@ -73,9 +81,13 @@ void TactileContactTopicProperty::fillTopicList()
 }
 
 
+const unsigned int TactileContactDisplay::NO_ID;
+
 TactileContactDisplay::TactileContactDisplay()
   : Display()
-  , full_update_(true)
+  , full_update_(true), reset_trails_(true)
+  , num_contacts_(0), update_count_(0), lru_first_(NO_ID), lru_last_(NO_ID)
+  , force_arrows_(0), torque_arrows_(0), trails_(0)
 {
   topic_property_ = new TactileContactTopicProperty
       ("Topic", "tactile_contact_states", "", this, SLOT(onTopicChanged()));
@@ -92,6 +104,14 @@ TactileContactDisplay::TactileContactDisplay()
   timeout_property_ = new rviz::FloatProperty
       ("Display timeout", 1, "", this);
 
+  max_contacts_property_ = new rviz::IntProperty
+      ("Max contacts", 100, "maximum number of displayed contacts, least recently updated ones are dropped", this);
+  max_contacts_property_->setMin(1);
+
+  batch_property_ = new rviz::BoolProperty
+      ("Batch arrows", true, "render all force and torque arrows with a single draw call each "
+       "(torques are shown as arrows only)", this);
+
   force_color_property_ = new rviz::ColorProperty
       ("Force Color", QColor( 204, 51, 51 ), "Color to draw force arrows.",
        this, SLOT(triggerFullUpdate()));
@@ -112,11 +132,33 @@ TactileContactDisplay::TactileContactDisplay()
       ("Torque Arrow Scale", 1.0, "", scale_property_, SLOT(triggerFullUpdate()), this);
   width_property_ = new rviz::FloatProperty
       ( "Arrow Width", 1.0, "", scale_property_, SLOT(triggerFullUpdate()), this);
+
+  trails_property_ = new rviz::BoolProperty
+      ("Show trails", false, "show recent positions of contacts", this, SLOT(triggerTrailsReset()));
+  trail_duration_property_ = new rviz::FloatProperty
+      ("Duration", 2.0, "time span (s) covered by trails", trails_property_);
+  trail_duration_property_->setMin(0);
+  trail_samples_property_ = new rviz::IntProperty
+      ("Samples", 100, "maximum number of samples per trail", trails_property_, SLOT(triggerTrailsReset()), this);
+  trail_samples_property_->setMin(2);
+  trail_width_property_ = new rviz::FloatProperty
+      ("Width", 0.002, "", trails_property_);
+  trail_width_property_->setMin(0);
 }
 
 TactileContactDisplay::~TactileContactDisplay()
 {
   unsubscribe();
+  if (force_arrows_) {
+    scene_node_->detachObject(force_arrows_);
+    scene_node_->detachObject(torque_arrows_);
+  }
+  delete force_arrows_;
+  delete torque_arrows_;
+  if (trails_) {
+    context_->getSceneManager()->destroyBillboardChain(trails_);
+    Ogre::MaterialManager::getSingleton().remove(trail_material_->getName());
+  }
 }
 
 void TactileContactDisplay::subscribe()
@@ -157,7 +199,15 @@ void TactileContactDisplay::subscribe()
 void TactileContactDisplay::unsubscribe()
 {
   sub_.shutdown();
+
+  boost::unique_lock<boost::mutex> lock(mutex_);
   contacts_.clear();
+  free_ids_.clear();
+  ids_.clear();
+  num_contacts_ = 0;
+  lru_first_ = lru_last_ = NO_ID;
+  pool_.clear();
+  reset_trails_ = true;
 }
 
 void TactileContactDisplay::setTopic(const QString &topic, const QString &datatype)
@@ -167,6 +217,25 @@ void TactileContactDisplay::setTopic(const QString &topic, const QString &dataty
 
 void TactileContactDisplay::onInitialize()
 {
+  force_arrows_ = new ArrowBatch();
+  torque_arrows_ = new ArrowBatch();
+  scene_node_->attachObject(force_arrows_);
+  scene_node_->attachObject(torque_arrows_);
+
+  static int count = 0;
+  std::stringstream ss;
+  ss << "tactile contact trails material " << count++;
+  trail_material_ = Ogre::MaterialManager::getSingleton().create(ss.str(), Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::Technique *technique = trail_material_->getTechnique(0);
+  technique->setLightingEnabled(false);  // use vertex colors
+  technique->setSceneBlending(Ogre::SBT_TRANSPARENT_ALPHA);
+  technique->setDepthWriteEnabled(false);
+
+  trails_ = context_->getSceneManager()->createBillboardChain();
+  trails_->setUseTextureCoords(false);
+  trails_->setUseVertexColours(true);
+  trails_->setMaterialName(trail_material_->getName());
+  scene_node_->attachObject(trails_);
 }
 
 void TactileContactDisplay::reset()
@@ -193,6 +262,7 @@ void TactileContactDisplay::onTopicChanged()
 
 void TactileContactDisplay::onTFPrefixChanged()
 {
+  resolved_frames_.clear();
   clearStatuses();
   context_->queueRender();
 }
@@ -203,16 +273,161 @@ void TactileContactDisplay::triggerFullUpdate()
   context_->queueRender();
 }
 
-void TactileContactDisplay::processMessage(const tactile_msgs::TactileContact &msg)
+void TactileContactDisplay::triggerTrailsReset()
+{
+  reset_trails_ = true;
+  context_->queueRender();
+}
+
+void TactileContactDisplay::resetTrails()
+{
+  const bool enabled = trails_property_->getBool();
+  const size_t samples = enabled ? trail_samples_property_->getInt() : 0;
+  const size_t chains = std::max<size_t>(1, std::max<size_t>(contacts_.size(), max_contacts_property_->getInt()));
+
+  trails_->clearAllChains();
+  trails_->setMaxChainElements(std::max<size_t>(samples, 2));
+  trails_->setNumberOfChains(chains);
+  trails_->setVisible(enabled);
+  for (auto it = contacts_.begin(), end = contacts_.end(); it != end; ++it) {
+    it->trail.setCapacity(samples);
+    it->trail_update = it->last_update - 1;  // enforce recording of current sample
+  }
+  reset_trails_ = false;
+}
+
+void TactileContactDisplay::updateTrail(unsigned int id, Contact &contact, const ros::Time &now,
+                                        const Ogre::Vector3 &position, const Ogre::Vector3 &force,
+                                        const Ogre::ColourValue &color)
+{
+  // drop expired samples
+  const double duration = trail_duration_property_->getFloat();
+  while (!contact.trail.empty() && (now - contact.trail.front().stamp).toSec() > duration) {
+    contact.trail.pop();
+    trails_->removeChainElement(id);
+  }
+
+  if (contact.trail_update == contact.last_update) return;  // no new data
+  contact.trail_update = contact.last_update;
+
+  TrailSample sample;
+  sample.stamp = now;
+  sample.position = position;
+  sample.force = force;
+  // if trail is full, the chain drops its oldest element too
+  contact.trail.push(sample);
+  trails_->addChainElement(id, Ogre::BillboardChain::Element
+                           (position, trail_width_property_->getFloat(), 0, color, Ogre::Quaternion::IDENTITY));
+}
+
+const std::string &TactileContactDisplay::resolveFrame(const std::string &frame_id)
 {
-  std::string id = msg.header.frame_id + msg.name;
-  auto it = contacts_.find(id);
-  if (it != contacts_.end()) {
-    tactile_msgs::TactileContact &m = it->second.first;
-    m = msg;
+  auto it = resolved_frames_.find(frame_id);
+  if (it == resolved_frames_.end()) {
+    const std::string& tf_prefix = tf_prefix_property_->getStdString();
+    it = resolved_frames_.insert(std::make_pair(frame_id, tf_prefix.empty() ? frame_id
+                                                : tf::resolve(tf_prefix, frame_id))).first;
+  }
+  return it->second;
+}
+
+unsigned int TactileContactDisplay::contactId(const std::string &frame_id, const std::string &name)
+{
+  boost::unordered_map<std::string, unsigned int> &names = ids_[frame_id];
+  auto it = names.find(name);
+  if (it != names.end())
+    return it->second;
+
+  // make room for the new contact
+  while (num_contacts_ >= static_cast<unsigned int>(max_contacts_property_->getInt()))
+    evictLRU();
+
+  unsigned int id;
+  if (free_ids_.empty()) {
+    id = contacts_.size();
+    contacts_.push_back(Contact());
+    contacts_.back().trail.setCapacity(trails_property_->getBool() ? trail_samples_property_->getInt() : 0);
+    if (id >= trails_->getNumberOfChains())
+      reset_trails_ = true;  // need more chains
   } else {
-    contacts_.insert(std::make_pair(id, std::make_pair(msg, WrenchVisualPtr())));
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  }
+  contacts_[id].used = true;
+  contacts_[id].trail_update = 0;
+  ++num_contacts_;
+  names.insert(std::make_pair(name, id));
+  return id;
+}
+
+void TactileContactDisplay::evict(unsigned int id)
+{
+  Contact &contact = contacts_[id];
+  releaseVisual(contact);
+  if (!contact.trail.empty()) {
+    contact.trail.clear();
+    trails_->clearChain(id);
   }
+  ids_[contact.msg.header.frame_id].erase(contact.msg.name);
+  contact.used = false;
+  unlink(id);
+  free_ids_.push_back(id);
+  --num_contacts_;
+}
+
+void TactileContactDisplay::evictLRU()
+{
+  if (lru_last_ != NO_ID)
+    evict(lru_last_);
+}
+
+void TactileContactDisplay::unlink(unsigned int id)
+{
+  Contact &contact = contacts_[id];
+  if (contact.prev != NO_ID) contacts_[contact.prev].next = contact.next;
+  else if (lru_first_ == id) lru_first_ = contact.next;
+  else return;  // not linked
+  if (contact.next != NO_ID) contacts_[contact.next].prev = contact.prev;
+  else lru_last_ = contact.prev;
+  contact.prev = contact.next = NO_ID;
+}
+
+void TactileContactDisplay::touch(unsigned int id)
+{
+  if (lru_first_ == id) return;
+  unlink(id);
+  Contact &contact = contacts_[id];
+  contact.next = lru_first_;
+  if (lru_first_ != NO_ID) contacts_[lru_first_].prev = id;
+  else lru_last_ = id;
+  lru_first_ = id;
+}
+
+void TactileContactDisplay::releaseVisual(Contact &contact)
+{
+  if (!contact.visual) return;
+  contact.visual->setVisible(false);
+  pool_.push_back(contact.visual);
+  contact.visual.reset();
+}
+
+WrenchVisualPtr TactileContactDisplay::acquireVisual()
+{
+  if (pool_.empty())
+    return WrenchVisualPtr(new WrenchVisual(context_->getSceneManager(), scene_node_));
+
+  WrenchVisualPtr visual = pool_.back();
+  pool_.pop_back();
+  return visual;
+}
+
+void TactileContactDisplay::processMessage(const tactile_msgs::TactileContact &msg)
+{
+  const unsigned int id = contactId(msg.header.frame_id, msg.name);
+  Contact &contact = contacts_[id];
+  contact.msg = msg;
+  contact.last_update = ++update_count_;
+  touch(id);
 }
 
 void TactileContactDisplay::processMessage(const tactile_msgs::TactileContact::ConstPtr& msg)
@@ -238,17 +453,41 @@ void TactileContactDisplay::update(float wall_dt, float ros_dt)
   ros::Time now = ros::Time::now();
   ros::Duration timeout(timeout_property_->getFloat());
 
+  Ogre::ColourValue force_color = force_color_property_->getOgreColor();
+  Ogre::ColourValue torque_color = torque_color_property_->getOgreColor();
+  float alpha = alpha_property_->getFloat();
+  force_color.a = torque_color.a = alpha;
+  const Ogre::uint32 force_abgr = force_color.getAsABGR();
+  const Ogre::uint32 torque_abgr = torque_color.getAsABGR();
+
+  float scale = scale_property_->getFloat();
+  float force_scale = scale * force_scale_property_->getFloat();
+  float torque_scale = scale * torque_scale_property_->getFloat();
+  float width = scale * width_property_->getFloat();
+
+  const bool batched = batch_property_->getBool();
+  force_arrows_->clear();
+  torque_arrows_->clear();
+
   boost::unique_lock<boost::mutex> lock(mutex_);
-  for (auto it = contacts_.begin(), end = contacts_.end(); it != end; ++it) {
-    const tactile_msgs::TactileContact &msg = it->second.first;
-    WrenchVisualPtr &visual = it->second.second;
-    bool new_visual = !visual;
+  // shrink to max number of contacts
+  const unsigned int max_contacts = max_contacts_property_->getInt();
+  while (num_contacts_ > max_contacts)
+    evictLRU();
+  if (pool_.size() > max_contacts)
+    pool_.resize(max_contacts);
+  if (reset_trails_)
+    resetTrails();
+  const bool trails = trails_property_->getBool();
+
+  for (unsigned int id = 0, end = contacts_.size(); id != end; ++id) {
+    Contact &contact = contacts_[id];
+    if (!contact.used) continue;
+    const tactile_msgs::TactileContact &msg = contact.msg;
+    const std::string& frame = resolveFrame(msg.header.frame_id);
     if (msg.header.stamp != zeroStamp && msg.header.stamp + timeout < now) {
-      const std::string& tf_prefix = tf_prefix_property_->getStdString();
-      const std::string& frame = tf_prefix.empty() ? msg.header.frame_id
-                                                   : tf::resolve(tf_prefix, msg.header.frame_id);
       setStatusStd(StatusProperty::Warn, frame, "no recent msg");
-      if (visual) visual->setVisible(false);
+      evict(id);  // stale contacts are dropped, recycling their visual
       continue;
     }
 
@@ -256,35 +495,44 @@ void TactileContactDisplay::update(float wall_dt, float ros_dt)
     Ogre::Vector3 position;
     Ogre::Quaternion orientation;
 
-    const std::string& tf_prefix = tf_prefix_property_->getStdString();
-    const std::string& frame = tf_prefix.empty() ? msg.header.frame_id
-                                                 : tf::resolve(tf_prefix, msg.header.frame_id);
-    // use zeroStamp to fetch most recent frame (tf is lacking behind our timestamps which caused issues)
-    if (!context_->getFrameManager()->getTransform(frame, zeroStamp,
-                                                   position, orientation)) {
+    // use most recent frame (tf is lacking behind our timestamps which caused issues)
+    if (!context_->getFrameManager()->getTransform(frame, ros::Time(), position, orientation)) {
       std::string error;
       context_->getFrameManager()->transformHasProblems(frame, msg.header.stamp, error);
       setStatusStd(StatusProperty::Error, frame, error);
-      if (visual) visual->setVisible(false);
+      releaseVisual(contact);
       continue;
     } else {
       setStatusStd(StatusProperty::Ok, frame, "");
     }
 
-    // create visual if not yet done
-    if (new_visual)
-      visual.reset(new WrenchVisual(context_->getSceneManager(), scene_node_));
+    Ogre::Vector3 force(msg.wrench.force.x, msg.wrench.force.y, msg.wrench.force.z);
+    Ogre::Vector3 torque(msg.wrench.torque.x, msg.wrench.torque.y, msg.wrench.torque.z);
 
-    if (this->full_update_ || new_visual) {
-      Ogre::ColourValue force_color = force_color_property_->getOgreColor();
-      Ogre::ColourValue torque_color = torque_color_property_->getOgreColor();
-      float alpha = alpha_property_->getFloat();
+    if (at_contact_point_property_->getBool()) {
+      Ogre::Vector3 contact_pos(msg.position.x, msg.position.y, msg.position.z);
+      force = -force;
+      torque += contact_pos.crossProduct(force);
+      position += orientation * contact_pos;
+    }
+
+    if (trails)
+      updateTrail(id, contact, now, position, orientation * force, force_color);
 
-      float scale = scale_property_->getFloat();
-      float force_scale = scale * force_scale_property_->getFloat();
-      float torque_scale = scale * torque_scale_property_->getFloat();
-      float width = scale * width_property_->getFloat();
+    if (batched) {
+      releaseVisual(contact);
+      force_arrows_->add(position, orientation * force, force_scale * force.length(), width, force_abgr);
+      torque_arrows_->add(position, orientation * torque, torque_scale * torque.length(), width, torque_abgr);
+      continue;
+    }
+
+    // fetch a visual if not yet done
+    WrenchVisualPtr &visual = contact.visual;
+    bool new_visual = !visual;
+    if (new_visual)
+      visual = acquireVisual();
 
+    if (this->full_update_ || new_visual) {
       visual->setForceColor(force_color.r, force_color.g, force_color.b, alpha);
       visual->setTorqueColor(torque_color.r, torque_color.g, torque_color.b, alpha);
       visual->setForceScale(force_scale);
@@ -292,20 +540,13 @@ void TactileContactDisplay::update(float wall_dt, float ros_dt)
       visual->setWidth(width);
     }
 
-    Ogre::Vector3 force(msg.wrench.force.x, msg.wrench.force.y, msg.wrench.force.z);
-    Ogre::Vector3 torque(msg.wrench.torque.x, msg.wrench.torque.y, msg.wrench.torque.z);
-
-    if (at_contact_point_property_->getBool()) {
-      Ogre::Vector3 contact_pos(msg.position.x, msg.position.y, msg.position.z);
-      force = -force;
-      torque += contact_pos.crossProduct(force);
-      position += orientation * contact_pos;
-    }
     visual->setVisible(true);
     visual->setFramePosition(position);
     visual->setFrameOrientation(orientation);
     visual->setWrench(force, torque);
   }
+  force_arrows_->update();
+  torque_arrows_->update();
   this->full_update_ = false;
 }
 
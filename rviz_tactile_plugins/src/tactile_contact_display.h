@@ -35,15 +35,27 @@
 #include <rviz/properties/ros_topic_property.h>
 #include <tactile_msgs/TactileContacts.h>
 #include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include "ring_buffer.h"
+#include <OgreVector3.h>
+#include <OgreColourValue.h>
+#include <OgreMaterial.h>
+
+namespace Ogre
+{
+class BillboardChain;
+}
 
 namespace rviz
 {
 class FloatProperty;
+class IntProperty;
 class ColorProperty;
 class WrenchVisual;
 
 namespace tactile
 {
+class ArrowBatch;
 
 class TactileContactTopicProperty : public rviz::RosTopicProperty {
 Q_OBJECT
@@ -69,6 +81,24 @@ public:
   ~TactileContactDisplay();
 
 protected:
+  struct TrailSample {
+    ros::Time stamp;
+    Ogre::Vector3 position;  /// contact position in fixed frame
+    Ogre::Vector3 force;  /// force in fixed frame
+  };
+  static const unsigned int NO_ID = ~0u;
+  struct Contact {
+    Contact() : last_update(0), used(false), prev(NO_ID), next(NO_ID), trail_update(0) {}
+
+    tactile_msgs::TactileContact msg;
+    WrenchVisualPtr visual;
+    unsigned long last_update;  /// update sequence number
+    bool used;  /// slot in use?
+    unsigned int prev, next;  /// neighbours in LRU list: more / less recently updated contact
+    RingBuffer<TrailSample> trail;  /// recent positions and forces
+    unsigned long trail_update;  /// last_update recorded in trail
+  };
+
   void subscribe();
   void unsubscribe();
 
@@ -82,25 +112,68 @@ protected:
   void processMessage(const tactile_msgs::TactileContact &msg);
   void processMessage(const tactile_msgs::TactileContact::ConstPtr& msg);
   void processMessages(const tactile_msgs::TactileContacts::ConstPtr& msg);
+  /// resolve frame_id w.r.t. tf prefix (cached)
+  const std::string &resolveFrame(const std::string &frame_id);
+
+  /// find or create contact slot for given key
+  unsigned int contactId(const std::string &frame_id, const std::string &name);
+  /// release contact slot (and its visual)
+  void evict(unsigned int id);
+  /// evict least recently updated contact
+  void evictLRU();
+  /// remove contact from LRU list
+  void unlink(unsigned int id);
+  /// (re)insert contact as most recently updated one into LRU list
+  void touch(unsigned int id);
+  /// fetch a visual from pool_ or create a new one
+  WrenchVisualPtr acquireVisual();
+  /// return contact's visual to pool_
+  void releaseVisual(Contact &contact);
+  /// (re)allocate trails for current settings, discarding all samples
+  void resetTrails();
+  /// drop expired samples from contact's trail and record a new sample if contact was updated
+  void updateTrail(unsigned int id, Contact &contact, const ros::Time &now,
+                   const Ogre::Vector3 &position, const Ogre::Vector3 &force, const Ogre::ColourValue &color);
 
 protected Q_SLOTS:
   void onTopicChanged();
   void onTFPrefixChanged();
   void triggerFullUpdate();
+  void triggerTrailsReset();
 
 private:
   TactileContactTopicProperty* topic_property_;
   rviz::StringProperty* tf_prefix_property_;
   rviz::BoolProperty* at_contact_point_property_;
   rviz::FloatProperty* timeout_property_;
+  rviz::IntProperty* max_contacts_property_;
+  rviz::BoolProperty* batch_property_;
   rviz::ColorProperty *force_color_property_, *torque_color_property_;
   rviz::FloatProperty *alpha_property_;
   rviz::FloatProperty *scale_property_, *force_scale_property_, *torque_scale_property_, *width_property_;
+  rviz::BoolProperty* trails_property_;
+  rviz::FloatProperty* trail_duration_property_;
+  rviz::IntProperty* trail_samples_property_;
+  rviz::FloatProperty* trail_width_property_;
   bool full_update_; // update all visual properties?
+  bool reset_trails_; // reallocate trails?
 
   ros::NodeHandle  nh_;
   ros::Subscriber  sub_;
-  std::map<std::string, std::pair<tactile_msgs::TactileContact, WrenchVisualPtr> > contacts_;
+  std::vector<Contact> contacts_;  /// dense contact storage, indexed by contact id
+  std::vector<unsigned int> free_ids_;  /// unused slots of contacts_
+  unsigned int num_contacts_;  /// number of used slots
+  unsigned long update_count_;  /// sequence number of contact updates
+  unsigned int lru_first_, lru_last_;  /// most / least recently updated contact (NO_ID if none)
+  /// contact ids by frame_id and name
+  boost::unordered_map<std::string, boost::unordered_map<std::string, unsigned int> > ids_;
+  std::vector<WrenchVisualPtr> pool_;  /// hidden, recyclable visuals
+  ArrowBatch *force_arrows_;  /// batched rendering of all force arrows
+  ArrowBatch *torque_arrows_;  /// batched rendering of all torque arrows
+  Ogre::BillboardChain *trails_;  /// one chain per contact id
+  Ogre::MaterialPtr trail_material_;
+
+  boost::unordered_map<std::string, std::string> resolved_frames_;  // frame_id -> resolved frame
   boost::mutex mutex_;
 };
 
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tactile_history.h"
+#include <algorithm>
+#include <limits>
+
+namespace rviz {
+namespace tactile {
+
+// quantization of range [-1,1], INVALID is reserved for non-finite values
+static const uint16_t INVALID = 0xFFFF;
+static const float SCALE = (INVALID - 1) / 2.0f;
+
+TactileHistory::TactileHistory()
+  : num_values_(0), quantized_(true), begin_(0), size_(0)
+{
+}
+
+size_t TactileHistory::bytes(size_t num_values, bool quantized)
+{
+  return sizeof(ros::Time) + num_values * (quantized ? sizeof(uint16_t) : sizeof(float));
+}
+
+void TactileHistory::init(size_t num_values, size_t capacity, bool quantized)
+{
+  num_values_ = num_values;
+  quantized_ = quantized;
+  stamps_.resize(capacity);
+  if (quantized) {
+    quantized_values_.resize(capacity * num_values);
+    std::vector<float>().swap(values_);
+  } else {
+    values_.resize(capacity * num_values);
+    std::vector<uint16_t>().swap(quantized_values_);
+  }
+  clear();
+}
+
+void TactileHistory::append(const ros::Time &stamp, const float *values)
+{
+  if (stamps_.empty()) return;
+  if (size_ && stamp < this->stamp(size_ - 1))
+    clear();  // time jumped back
+
+  size_t s;
+  if (size_ == stamps_.size()) {  // overwrite oldest
+    s = begin_;
+    begin_ = slot(1);
+  } else {
+    s = slot(size_++);
+  }
+  stamps_[s] = stamp;
+
+  if (quantized_) {
+    uint16_t *out = &quantized_values_[s * num_values_];
+    for (const float *v = values, *end = values + num_values_; v != end; ++v, ++out) {
+      if (*v - *v == 0) // finite
+        *out = static_cast<uint16_t>((std::min(1.0f, std::max(-1.0f, *v)) + 1.0f) * SCALE + 0.5f);
+      else
+        *out = INVALID;
+    }
+  } else {
+    std::copy(values, values + num_values_, values_.begin() + s * num_values_);
+  }
+}
+
+bool TactileHistory::find(const ros::Time &stamp, size_t &index) const
+{
+  if (size_ == 0 || stamp < this->stamp(0)) return false;
+
+  // binary search for first snapshot newer than stamp
+  size_t lo = 1, hi = size_;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (this->stamp(mid) <= stamp) lo = mid + 1;
+    else hi = mid;
+  }
+  index = lo - 1;
+  return true;
+}
+
+void TactileHistory::get(size_t i, float *values) const
+{
+  const size_t s = slot(i);
+  if (quantized_) {
+    const uint16_t *in = &quantized_values_[s * num_values_];
+    for (float *v = values, *end = values + num_values_; v != end; ++v, ++in)
+      *v = *in == INVALID ? std::numeric_limits<float>::quiet_NaN() : *in / SCALE - 1.0f;
+  } else {
+    std::copy(values_.begin() + s * num_values_, values_.begin() + (s+1) * num_values_, values);
+  }
+}
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <ros/time.h>
+#include <vector>
+#include <stdint.h>
+#include <cstddef>
+
+namespace rviz {
+namespace tactile {
+
+/** Ring buffer of value snapshots of a sensor, used to replay recent tactile data.
+ *
+ *  Storage for all snapshots is allocated once by init(). Snapshots are appended in O(1),
+ *  overwriting the oldest one when full, and looked up by time in O(log n).
+ *  Values are expected in range [-1,1] (normalized values) and can be quantized to 16 bit.
+ */
+class TactileHistory
+{
+public:
+  TactileHistory();
+
+  /// allocate storage for capacity snapshots of num_values values each, discarding all snapshots
+  void init(size_t num_values, size_t capacity, bool quantized);
+  void clear() {begin_ = size_ = 0;}
+
+  size_t capacity() const {return stamps_.size();}
+  size_t size() const {return size_;}
+  bool empty() const {return size_ == 0;}
+  /// number of bytes needed per snapshot
+  static size_t bytes(size_t num_values, bool quantized);
+
+  /// append snapshot of num_values values
+  void append(const ros::Time &stamp, const float *values);
+  /// find index (0: oldest) of most recent snapshot not newer than stamp, false if there is none
+  bool find(const ros::Time &stamp, size_t &index) const;
+  /// stamp of snapshot i
+  const ros::Time &stamp(size_t i) const {return stamps_[slot(i)];}
+  /// retrieve values of snapshot i
+  void get(size_t i, float *values) const;
+
+private:
+  size_t slot(size_t i) const {i += begin_; return i >= stamps_.size() ? i - stamps_.size() : i;}
+
+  size_t num_values_;
+  bool quantized_;
+  size_t begin_;  /// slot of oldest snapshot
+  size_t size_;
+  std::vector<ros::Time> stamps_;
+  std::vector<uint16_t> quantized_values_;  /// capacity x num_values (if quantized_)
+  std::vector<float> values_;  /// capacity x num_values (if !quantized_)
+};
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "tactile_pipeline.h"
+
+namespace rviz {
+namespace tactile {
+
+TactilePipeline::TactilePipeline()
+  : mode_(::tactile::TactileValue::rawCurrent)
+  , acc_mode_(::tactile::TactileValueArray::Sum), acc_mean_(true)
+{
+}
+
+void TactilePipeline::init(size_t num)
+{
+  values_.init(num);
+  normalized_.assign(num, 0);
+  color_indices_.clear();
+}
+
+void TactilePipeline::update(const std::vector<float> &values)
+{
+  values_.updateValues(values);
+  for (auto it = values_.begin(), end = values_.end(); it != end; ++it)
+    raw_range_.update(it->absRange());
+}
+
+void TactilePipeline::assign(const ::tactile::TactileValueArray &values, const ::tactile::Range &raw_range)
+{
+  values_ = values;
+  raw_range_ = raw_range;
+}
+
+void TactilePipeline::reset()
+{
+  values_.reset();
+}
+
+void TactilePipeline::setRawRange(float min, float max)
+{
+  for (auto &&v : values_)
+    v.init(min, max);
+  raw_range_.init(min, max);
+}
+
+void TactilePipeline::setAccumulationMode(::tactile::TactileValueArray::AccMode mode, bool mean)
+{
+  acc_mode_ = mode;
+  acc_mean_ = mean;
+}
+
+float TactilePipeline::accumulated()
+{
+  return values_.accumulate(mode_, acc_mode_, acc_mean_);
+}
+
+float TactilePipeline::rawValue(size_t taxel)
+{
+  return (values_.begin() + taxel)->value(::tactile::TactileValue::rawCurrent);
+}
+
+float TactilePipeline::filteredValue(size_t taxel)
+{
+  return (values_.begin() + taxel)->value(mode_);
+}
+
+float TactilePipeline::mapValue(const ::tactile::TactileValue &value) const
+{
+  float v = value.value(mode_);
+  // normalize to range 0..1
+  if (mode_ == ::tactile::TactileValue::rawCurrent ||
+      mode_ == ::tactile::TactileValue::rawMean) {
+    v = (v - raw_range_.min()) / raw_range_.range();
+  }
+  return v;
+}
+
+void TactilePipeline::normalize()
+{
+  normalized_.resize(values_.size());
+  auto n = normalized_.begin();
+  for (auto it = values_.begin(), end = values_.end(); it != end; ++it, ++n)
+    *n = mapValue(*it);
+}
+
+const std::vector<unsigned int> &TactilePipeline::quantize(const ColorLUT &lut, bool all)
+{
+  static const unsigned int UNKNOWN = ~0u;
+  if (all || color_indices_.size() != normalized_.size())
+    color_indices_.assign(normalized_.size(), UNKNOWN);
+
+  // quantize all values in a single batch
+  new_indices_.resize(normalized_.size());
+  if (!normalized_.empty())
+    lut.index(&normalized_.front(), &normalized_.front() + normalized_.size(), &new_indices_.front());
+
+  // only consider taxels whose quantized color changed
+  changed_.clear();
+  for (size_t i = 0, end = new_indices_.size(); i != end; ++i) {
+    if (new_indices_[i] == color_indices_[i]) continue;
+    color_indices_[i] = new_indices_[i];
+    changed_.push_back(i);
+  }
+  return changed_;
+}
+
+void TactilePipeline::map(const ColorLUT &lut, uint32_t *out) const
+{
+  if (!normalized_.empty())
+    lut.map(&normalized_.front(), &normalized_.front() + normalized_.size(), out);
+}
+
+} // namespace tactile
+} // namespace rviz
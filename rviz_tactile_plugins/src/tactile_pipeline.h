@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include "color_lut.h"
+#include <tactile_filters/TactileValueArray.h>
+#include <tactile_filters/TactileValue.h>
+#include <vector>
+#include <stdint.h>
+
+namespace rviz {
+namespace tactile {
+
+/** Value pipeline of a single tactile sensor, independent of Qt, Ogre, and ROS.
+ *
+ *  Raw readings are ingested into filtered TactileValues, normalized w.r.t. the current
+ *  display mode, and quantized into color indices of a ColorLUT. Only taxels whose color
+ *  index changed need to be updated by the renderer. TactileVisualBase is a thin adapter
+ *  passing the results to Ogre.
+ */
+class TactilePipeline
+{
+public:
+  TactilePipeline();
+
+  /// (re)initialize for num taxels
+  void init(size_t num);
+  /// number of taxels
+  size_t size() const {return values_.size();}
+
+  /// ingest new raw readings (size() values), updating filters and raw range
+  void update(const std::vector<float> &values);
+  /// adopt filtered values and raw range, e.g. from a pipeline updated in another thread
+  void assign(const ::tactile::TactileValueArray &values, const ::tactile::Range &raw_range);
+  /// filtered values
+  const ::tactile::TactileValueArray &values() const {return values_;}
+  /// reset filters
+  void reset();
+  /// initialize raw range (of all taxels) to [min, max]
+  void setRawRange(float min, float max);
+  const ::tactile::Range &rawRange() const {return raw_range_;}
+
+  void setMode(::tactile::TactileValue::Mode mode) {mode_ = mode;}
+  ::tactile::TactileValue::Mode mode() const {return mode_;}
+  void setAccumulationMode(::tactile::TactileValueArray::AccMode mode, bool mean);
+  void setMeanLambda (float fLambda) {values_.setMeanLambda(fLambda);}
+  void setRangeLambda (float fLambda) {values_.setRangeLambda(fLambda);}
+  void setReleaseDecay (float fDecay) {values_.setReleaseDecay(fDecay);}
+
+  /// value accumulated across all taxels according to accumulation mode
+  float accumulated();
+  /// raw value of taxel
+  float rawValue(size_t taxel);
+  /// value of taxel w.r.t. current mode
+  float filteredValue(size_t taxel);
+  /// value w.r.t. current mode, normalized to 0..1 for raw modes
+  float mapValue(const ::tactile::TactileValue &value) const;
+
+  /// compute normalized() from filtered values
+  void normalize();
+  /// normalized values (writable to restore recorded ones)
+  std::vector<float> &normalized() {return normalized_;}
+  const std::vector<float> &normalized() const {return normalized_;}
+
+  /// quantize normalized() via lut, returning taxels whose color index changed (all taxels if all=true)
+  const std::vector<unsigned int> &quantize(const ColorLUT &lut, bool all=false);
+  /// quantized color index of each taxel (as of last quantize())
+  const std::vector<unsigned int> &colorIndices() const {return color_indices_;}
+  /// map normalized() onto size() packed colors
+  void map(const ColorLUT &lut, uint32_t *out) const;
+
+private:
+  ::tactile::TactileValueArray values_;  /// filtered tactile values
+  ::tactile::Range raw_range_;  /// range of raw values across all taxels
+  ::tactile::TactileValue::Mode mode_;
+  ::tactile::TactileValueArray::AccMode acc_mode_;
+  bool acc_mean_;
+
+  std::vector<float> normalized_;  /// normalized values
+  std::vector<unsigned int> new_indices_;  /// color indices (temporary buffer of quantize())
+  std::vector<unsigned int> color_indices_;  /// quantized color index of each taxel
+  std::vector<unsigned int> changed_;  /// taxels whose color index changed in quantize()
+};
+
+} // namespace tactile
+} // namespace rviz
@@ -40,15 +40,22 @@
 
 #include <rviz/visualization_manager.h>
 #include <rviz/frame_manager.h>
+#include <rviz/view_manager.h>
+#include <rviz/view_controller.h>
+#include <rviz/properties/bool_property.h>
 #include <rviz/properties/color_property.h>
 #include <rviz/properties/float_property.h>
 #include <rviz/properties/int_property.h>
 #include <rviz/properties/parse_color.h>
 #include <rviz/properties/ros_topic_property.h>
+#include <rviz/properties/string_property.h>
 #include <rviz/properties/enum_property.h>
 #include <rviz/validate_floats.h>
 
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/bind.hpp>
+#include <ros/param.h>
 static const QString ROBOT_DESC = "robot description";
 
 using namespace urdf::tactile;
@@ -57,8 +64,12 @@ namespace rviz {
 namespace tactile {
 
 TactileStateDisplay::TactileStateDisplay()
-  : mode_(::tactile::TactileValue::rawCurrent)
+  : spinner_(1, &queue_)
+  , mode_(::tactile::TactileValue::rawCurrent)
 {
+  // process incoming messages in a separate thread, decoupled from rendering
+  nh_.setCallbackQueue(&queue_);
+
   topic_property_ = new rviz::RosTopicProperty
       ("topic", "/tactile_state", "tactile_msgs/TactileState", "",
        this, SLOT(onTopicChanged()));
@@ -74,6 +85,16 @@ TactileStateDisplay::TactileStateDisplay()
        "This option allows you to set a prefix. Mainly useful for multi-robot situations.",
        this, SLOT(onTFPrefixChanged()));
 
+  robots_property_ = new rviz::IntProperty
+      ("additional robots", 0, "number of additional robots using the same robot description, "
+       "each one with its own topic and TF prefix", this, SLOT(onRobotsChanged()));
+  robots_property_->setMin(0);
+  Robot robot;
+  robot.property = 0;
+  robot.topic = topic_property_;
+  robot.tf_prefix = tf_prefix_property_;
+  robots_.push_back(robot);
+
   mode_property_ = new rviz::EnumProperty
       ("display mode", QString::fromStdString(::tactile::TactileValue::getModeName(mode_)),
        "", this, SLOT(onModeChanged()));
@@ -96,6 +117,62 @@ TactileStateDisplay::TactileStateDisplay()
   timeout_property_ = new rviz::FloatProperty
       ("display timeout", 1, "", this);
 
+  refresh_rate_property_ = new rviz::FloatProperty
+      ("refresh rate", 60, "maximum rate (Hz) of taxel color updates (0: every frame)", this);
+  refresh_rate_property_->setMin(0);
+
+  property_rate_property_ = new rviz::FloatProperty
+      ("property refresh rate", 2, "maximum rate (Hz) of sensor property updates (0: every frame)", this);
+  property_rate_property_->setMin(0);
+
+  batch_property_ = new rviz::BoolProperty
+      ("batch taxels", true, "render all taxels of a sensor as a single mesh (one draw call per sensor)",
+       this, SLOT(onRobotDescriptionChanged()));
+
+  lod_threshold_property_ = new rviz::FloatProperty
+      ("LOD threshold", 3, "render clusters of taxels if taxels become smaller than this number of pixels "
+       "(0: disable level of detail, only available for batched taxels)", batch_property_);
+  lod_threshold_property_->setMin(0);
+
+  array_mode_property_ = new rviz::EnumProperty
+      ("array rendering", "texture", "render tactile arrays as boxes or as a single textured quad",
+       this, SLOT(onRobotDescriptionChanged()));
+  array_mode_property_->addOption("boxes", TactileArrayVisual::BOXES);
+  array_mode_property_->addOption("texture", TactileArrayVisual::TEXTURE);
+  array_mode_property_->addOption("smooth texture", TactileArrayVisual::SMOOTH_TEXTURE);
+
+  history_budget_property_ = new rviz::FloatProperty
+      ("history budget", 0, "memory (MB) used to record recent data of all sensors for pausing and scrubbing (0: disable)",
+       this, SLOT(onHistoryChanged()));
+  history_budget_property_->setMin(0);
+  history_quantize_property_ = new rviz::BoolProperty
+      ("quantized", true, "store values quantized to 16 bit, doubling the recorded time span",
+       history_budget_property_, SLOT(onHistoryChanged()), this);
+
+  pause_property_ = new rviz::BoolProperty
+      ("pause", false, "freeze display to replay recorded data (requires a history budget)", this, SLOT(onPauseChanged()));
+  history_offset_property_ = new rviz::FloatProperty
+      ("time offset", 0, "time (s) to go back in history from the moment of pausing",
+       pause_property_);
+  history_offset_property_->setMin(0);
+
+  selection_property_ = new rviz::StringProperty
+      ("selected taxel", "", "sensor of taxel selected with the Select Taxel tool", this);
+  selection_index_property_ = new rviz::IntProperty
+      ("index", 0, "index of taxel within sensor data", selection_property_);
+  selection_channel_property_ = new rviz::StringProperty
+      ("channel", "", "channel of sensor data", selection_property_);
+  selection_raw_property_ = new rviz::FloatProperty
+      ("raw value", 0, "current raw value", selection_property_);
+  selection_filtered_property_ = new rviz::FloatProperty
+      ("filtered value", 0, "current value w.r.t. display mode", selection_property_);
+  selection_property_->setReadOnly(true);
+  selection_index_property_->setReadOnly(true);
+  selection_channel_property_->setReadOnly(true);
+  selection_raw_property_->setReadOnly(true);
+  selection_filtered_property_->setReadOnly(true);
+  selection_property_->hide();
+
   sensors_property_ = new GroupProperty("sensors", true, "", this,
                                         SLOT(onAllVisibleChanged()));
   sensors_property_->collapse();
@@ -119,27 +196,32 @@ TactileStateDisplay::TactileStateDisplay()
 TactileStateDisplay::~TactileStateDisplay()
 {
   unsubscribe();
+  spinner_.stop();
 }
 
 void TactileStateDisplay::subscribe()
 {
-  if (!isEnabled() ||
-      topic_property_->getTopicStd().empty() ||
-      sensors_.empty())
+  if (!isEnabled() || sensors_.empty())
     return;
 
-  try {
-    sub_ = nh_.subscribe(topic_property_->getTopicStd(), 10,
-                         &TactileStateDisplay::processMessage, this);
-    setStatus(StatusProperty::Ok, "topic", "OK");
-  } catch(const ros::Exception& e) {
-    setStatus(StatusProperty::Error, "topic", QString("error subscribing: ") + e.what());
+  setStatus(StatusProperty::Ok, "topic", "OK");
+  for (size_t i = 0; i < robots_.size(); ++i) {
+    const std::string &topic = robots_[i].topic->getTopicStd();
+    if (topic.empty()) continue;
+    try {
+      robots_[i].sub = nh_.subscribe<tactile_msgs::TactileState>
+          (topic, 10, boost::bind(&TactileStateDisplay::processMessage, this, _1, i));
+    } catch(const ros::Exception& e) {
+      setStatus(StatusProperty::Error, "topic", QString("error subscribing to %1: %2")
+                .arg(QString::fromStdString(topic)).arg(e.what()));
+    }
   }
 }
 
 void TactileStateDisplay::unsubscribe()
 {
-  sub_.shutdown();
+  for (auto it = robots_.begin(), end = robots_.end(); it != end; ++it)
+    it->sub.shutdown();
 }
 
 void TactileStateDisplay::setTopic(const QString &topic, const QString &datatype)
@@ -149,6 +231,8 @@ void TactileStateDisplay::setTopic(const QString &topic, const QString &datatype
 
 void TactileStateDisplay::onInitialize()
 {
+  geometry_cache_ = GeometryCache::instance();
+  spinner_.start();
 }
 
 void TactileStateDisplay::reset()
@@ -202,74 +286,244 @@ GroupProperty* TactileStateDisplay::getGroupProperty(const QString &path, GroupP
   return parent;
 }
 
-void TactileStateDisplay::onRobotDescriptionChanged()
+template <typename T>
+static inline void hashCombine(size_t &seed, const T &value)
 {
-  // save settings of old sensors to restore them later
-  std::map<QString, rviz::Config> configs;
-  for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it) {
-    rviz::Config config;
-    it->second->save(config);
-    configs[it->second->getName()] = config;
-    delete it->second;
+  boost::hash_combine(seed, value);
+}
+
+static void hashCombine(size_t &seed, const urdf::Pose &pose)
+{
+  hashCombine(seed, pose.position.x); hashCombine(seed, pose.position.y); hashCombine(seed, pose.position.z);
+  hashCombine(seed, pose.rotation.x); hashCombine(seed, pose.rotation.y); hashCombine(seed, pose.rotation.z);
+  hashCombine(seed, pose.rotation.w);
+}
+
+static void hashCombine(size_t &seed, const urdf::Vector3 &v)
+{
+  hashCombine(seed, v.x); hashCombine(seed, v.y); hashCombine(seed, v.z);
+}
+
+static void hashCombine(size_t &seed, const urdf::Geometry &geom)
+{
+  hashCombine(seed, int(geom.type));
+  switch (geom.type)
+  {
+  case urdf::Geometry::SPHERE:
+    hashCombine(seed, static_cast<const urdf::Sphere&>(geom).radius);
+    break;
+  case urdf::Geometry::BOX:
+    hashCombine(seed, static_cast<const urdf::Box&>(geom).dim);
+    break;
+  case urdf::Geometry::CYLINDER:
+    hashCombine(seed, static_cast<const urdf::Cylinder&>(geom).radius);
+    hashCombine(seed, static_cast<const urdf::Cylinder&>(geom).length);
+    break;
+  case urdf::Geometry::MESH:
+    hashCombine(seed, static_cast<const urdf::Mesh&>(geom).filename);
+    hashCombine(seed, static_cast<const urdf::Mesh&>(geom).scale);
+    break;
+  default:
+    break;
   }
+}
 
+/// hash of all sensor properties relevant to create its visual
+static size_t sensorHash(const urdf::Sensor &sensor, const TactileSensor &tactile, int render_options)
+{
+  size_t seed = 0;
+  hashCombine(seed, render_options);
+  hashCombine(seed, sensor.parent_link_);
+  hashCombine(seed, sensor.group_);
+  hashCombine(seed, sensor.origin_);
+  hashCombine(seed, tactile.channel_);
+  if (tactile.array_) {
+    const TactileArray &array = *tactile.array_;
+    hashCombine(seed, array.rows); hashCombine(seed, array.cols); hashCombine(seed, int(array.order));
+    hashCombine(seed, array.size.x); hashCombine(seed, array.size.y);
+    hashCombine(seed, array.spacing.x); hashCombine(seed, array.spacing.y);
+    hashCombine(seed, array.offset.x); hashCombine(seed, array.offset.y);
+  }
+  for (auto it = tactile.taxels_.begin(), end = tactile.taxels_.end(); it != end; ++it) {
+    hashCombine(seed, (*it)->idx);
+    hashCombine(seed, (*it)->origin);
+    if ((*it)->geometry) hashCombine(seed, *(*it)->geometry);
+  }
+  return seed;
+}
+
+/// parse tactile sensors of a robot description, sharing the result between all displays
+static SensorMapConstPtr parseSensors(const std::string &param)
+{
+  static std::map<std::string, boost::weak_ptr<const urdf::SensorMap> > cache;  // by XML string
+
+  std::string xml;
+  if (!ros::param::get(param, xml))
+    throw std::runtime_error("could not read parameter " + param + " on parameter server");
+
+  for (auto it = cache.begin(); it != cache.end();) {
+    if (it->second.expired()) it = cache.erase(it);
+    else ++it;
+  }
+  SensorMapConstPtr sensors = cache[xml].lock();
+  if (!sensors) {
+    sensors.reset(new urdf::SensorMap(urdf::parseSensors(xml, urdf::getSensorParser("tactile"))));
+    cache[xml] = sensors;
+  }
+  return sensors;
+}
+
+TactileVisualBase *TactileStateDisplay::createVisual(const std::string &name, const urdf::Sensor &sensor,
+                                                     const TactileSensor &tactile,
+                                                     const TactileVisualBase *prototype)
+{
+  if (tactile.array_) {
+    return new TactileArrayVisual(name, sensor.parent_link_, sensor.origin_,
+                                  tactile.array_, this, context_, scene_node_, 0,
+                                  TactileArrayVisual::Mode(array_mode_property_->getOptionInt()));
+  } else if (tactile.taxels_.size()) {
+    return new TactileTaxelsVisual(name, sensor.parent_link_, sensor.origin_,
+                                   tactile.taxels_, this, context_, scene_node_, 0,
+                                   batch_property_->getBool(),
+                                   dynamic_cast<const TactileTaxelsVisual*>(prototype));
+  }
+  return 0;
+}
+
+void TactileStateDisplay::onRobotDescriptionChanged()
+{
+  // stop ingest before modifying sensors_
+  unsubscribe();
+  select(TaxelPick());
+
+  // existing sensors, accessible by robot index and name
+  typedef std::pair<size_t, std::string> Key;
+  std::map<Key, TactileVisualBase*> old_sensors;
+  for (size_t r = 0; r < robots_.size(); ++r) {
+    for (auto it = robots_[r].sensors.begin(), end = robots_[r].sensors.end(); it != end; ++it)
+      old_sensors[Key(r, it->second->getNameStd())] = it->second;
+    robots_[r].sensors.clear();
+  }
   sensors_.clear();
-  urdf::SensorMap sensors;
-  const std::string &tf_prefix = tf_prefix_property_->getStdString();
 
   try {
-    sensors = urdf::parseSensorsFromParam(robot_description_property_->getStdString(),
-                                          urdf::getSensorParser("tactile"));
-
-    // create a TactileVisual for each tactile sensor listed in the URDF model
-    for (auto it = sensors.begin(), end = sensors.end(); it != end; ++it)
-    {
-      urdf::tactile::TactileSensorConstSharedPtr sensor = urdf::tactile::tactile_sensor_cast(it->second);
-      if (!sensor) continue;  // some other sensor than tactile
-
-      TactileVisualBase *visual=0;
-      if (sensor->array_) {
-        visual = new TactileArrayVisual(it->first, it->second->parent_link_, it->second->origin_,
-                                        sensor->array_, this, context_, scene_node_);
-      } else if (sensor->taxels_.size()) {
-        visual = new TactileTaxelsVisual(it->first, it->second->parent_link_, it->second->origin_,
-                                         sensor->taxels_, this, context_, scene_node_);
-      }
-      if (visual) {
-        GroupProperty *group_property
-            = getGroupProperty(QString::fromStdString(it->second->group_), sensors_property_);
-        group_property->addChild(visual);
-        visual->setGroup(QString::fromStdString(it->second->group_));
-        visual->setTFPrefix(tf_prefix);
-        sensors_.insert(std::make_pair(sensor->channel_,visual));
+    model_ = parseSensors(robot_description_property_->getStdString());
+
+    // sensors of first robot serve as prototypes for other robots
+    std::map<std::string, TactileVisualBase*> prototypes;
+    for (size_t r = 0; r < robots_.size(); ++r) {
+      Robot &robot = robots_[r];
+      const std::string &tf_prefix = robot.tf_prefix->getStdString();
+      const QString robot_group = r ? QString("robot %1/").arg(r) : QString();
+
+      // create a TactileVisual for each tactile sensor listed in the URDF model
+      for (auto it = model_->begin(), end = model_->end(); it != end; ++it)
+      {
+        TactileSensorConstSharedPtr sensor = tactile_sensor_cast(it->second);
+        if (!sensor) continue;  // some other sensor than tactile
+
+        int render_options = sensor->array_ ? array_mode_property_->getOptionInt() : batch_property_->getBool();
+        size_t sensor_hash = sensorHash(*it->second, *sensor, render_options);
+
+        // keep unchanged sensors
+        auto old = old_sensors.find(Key(r, it->first));
+        TactileVisualBase *visual = 0;
+        if (old != old_sensors.end() && old->second->hash() == sensor_hash) {
+          visual = old->second;
+          old_sensors.erase(old);
+        } else {
+          visual = createVisual(it->first, *it->second, *sensor, r ? prototypes[it->first] : 0);
+          if (visual) {
+            const QString group = QString::fromStdString(it->second->group_);
+            getGroupProperty(robot_group + group, sensors_property_)->addChild(visual);
+            visual->setGroup(group);
+            visual->setHash(sensor_hash);
+          }
+
+          // replace changed sensor, restoring its settings
+          if (old != old_sensors.end()) {
+            if (visual) {
+              rviz::Config config;
+              old->second->save(config);
+              visual->load(config);
+            }
+            delete old->second;
+            old_sensors.erase(old);
+          }
+        }
+        if (!visual) continue;
 
-        // restore sensor settings (if available)
-        auto config = configs.find(visual->getName());
-        if (config != configs.end())
-          visual->load(config->second);
+        visual->setTFPrefix(tf_prefix);
+        if (r == 0) prototypes[it->first] = visual;
+        robot.sensors.insert(std::make_pair(sensor->channel_, visual));
+        sensors_.insert(std::make_pair(sensor->channel_, visual));
       }
     }
+    // stagger throttled updates across sensors
+    unsigned int index = 0;
+    for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it, ++index)
+      it->second->setUpdatePhase(float(index) / sensors_.size());
+
     if (sensors_.size())
-      setStatus(rviz::StatusProperty::Ok, ROBOT_DESC, QString("found %1 tactile sensors").arg(sensors_.size()));
+      setStatus(rviz::StatusProperty::Ok, ROBOT_DESC, QString("found %1 tactile sensors")
+                .arg(sensors_.size() / robots_.size()));
     else
       setStatus(rviz::StatusProperty::Warn, ROBOT_DESC, "no tactile sensors found");
   } catch (const std::exception &e) {
     setStatus(rviz::StatusProperty::Error, ROBOT_DESC, e.what());
   }
 
+  // remove sensors not present anymore
+  for (auto it = old_sensors.begin(), end = old_sensors.end(); it != end; ++it)
+    delete it->second;
+
   sensors_property_->removeEmptyChildren();
 
   onModeChanged();
   onModeParamsChanged();
+  onHistoryChanged();
   subscribe();
   context_->queueRender();
 }
 
+void TactileStateDisplay::onRobotsChanged()
+{
+  const size_t count = 1 + robots_property_->getInt();
+  if (count == robots_.size()) return;
+
+  unsubscribe();
+  select(TaxelPick());
+  while (robots_.size() > count) {
+    Robot &robot = robots_.back();
+    for (auto it = robot.sensors.begin(), end = robot.sensors.end(); it != end; ++it) {
+      for (auto s = sensors_.begin(); s != sensors_.end();) {
+        if (s->second == it->second) s = sensors_.erase(s);
+        else ++s;
+      }
+      delete it->second;
+    }
+    delete robot.property;
+    robots_.pop_back();
+  }
+  while (robots_.size() < count) {
+    Robot robot;
+    robot.property = new rviz::Property(QString("robot %1").arg(robots_.size()), QVariant(),
+                                        "topic and TF prefix of an additional robot", robots_property_);
+    robot.topic = new rviz::RosTopicProperty
+        ("topic", "", "tactile_msgs/TactileState", "", robot.property, SLOT(onTopicChanged()), this);
+    robot.tf_prefix = new rviz::StringProperty
+        ("TF Prefix", "", "", robot.property, SLOT(onTFPrefixChanged()), this);
+    robots_.push_back(robot);
+  }
+  onRobotDescriptionChanged();
+}
+
 void TactileStateDisplay::onTFPrefixChanged()
 {
-  const std::string &tf_prefix = tf_prefix_property_->getStdString();
-  for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it) {
-    it->second->setTFPrefix(tf_prefix);
+  for (auto robot = robots_.begin(), end = robots_.end(); robot != end; ++robot) {
+    const std::string &tf_prefix = robot->tf_prefix->getStdString();
+    for (auto it = robot->sensors.begin(), sensors_end = robot->sensors.end(); it != sensors_end; ++it)
+      it->second->setTFPrefix(tf_prefix);
   }
   clearStatuses();
   context_->queueRender();
@@ -317,19 +571,94 @@ void TactileStateDisplay::onAllVisibleChanged()
   }
 }
 
-// This is our callback to handle an incoming message.
-void TactileStateDisplay::processMessage(const tactile_msgs::TactileState::ConstPtr& msg)
+void TactileStateDisplay::onHistoryChanged()
 {
+  const bool quantized = history_quantize_property_->getBool();
+  size_t bytes = 0;  // memory needed for a snapshot of all sensors
+  for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it)
+    bytes += TactileHistory::bytes(it->second->numTaxels(), quantized);
+
+  // all sensors record the same number of snapshots
+  const size_t capacity = bytes ? history_budget_property_->getFloat() * (1 << 20) / bytes : 0;
+  for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it)
+    it->second->initHistory(capacity, quantized);
+  onPauseChanged();
+}
+
+void TactileStateDisplay::onPauseChanged()
+{
+  const bool paused = pause_property_->getBool();
+  history_end_ = ros::Time();
+  for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it) {
+    TactileVisualBase &sensor = *it->second;
+    sensor.setRecording(!paused);
+    sensor.invalidate();
+    const TactileHistory &history = sensor.history();
+    if (!history.empty())
+      history_end_ = std::max(history_end_, history.stamp(history.size() - 1));
+  }
+  context_->queueRender();
+}
+
+bool TactileStateDisplay::pick(const Ogre::Ray &ray, TaxelPick &result) const
+{
+  result = TaxelPick();
+  size_t taxel;
+  float distance;
+  for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it) {
+    TactileVisualBase *sensor = it->second;
+    if (!sensor->isVisible() || !sensor->isEnabled()) continue;
+    if (!sensor->pick(ray, taxel, distance)) continue;
+    if (result.sensor && distance >= result.distance) continue;
+    result.sensor = sensor;
+    result.channel = it->first;
+    result.taxel = taxel;
+    result.distance = distance;
+  }
+  return result.sensor != 0;
+}
+
+void TactileStateDisplay::select(const TaxelPick &pick)
+{
+  selection_ = pick;
+  if (!pick.sensor) {
+    selection_property_->hide();
+    return;
+  }
+  selection_property_->setStdString(pick.sensor->getNameStd());
+  selection_channel_property_->setStdString(pick.channel);
+  selection_index_property_->setInt(pick.sensor->dataIndex(pick.taxel));
+  updateSelection();
+  selection_property_->show();
+  selection_property_->expand();
+}
+
+void TactileStateDisplay::updateSelection()
+{
+  selection_raw_property_->setFloat(selection_.sensor->rawValue(selection_.taxel));
+  selection_filtered_property_->setFloat(selection_.sensor->filteredValue(selection_.taxel));
+}
+
+// This is our callback to handle an incoming message (called from spinner_ thread).
+void TactileStateDisplay::processMessage(const tactile_msgs::TactileState::ConstPtr& msg, size_t robot)
+{
+  const ros::Time now = ros::Time::now();
+  const std::multimap<std::string, TactileVisualBase*> &sensors = robots_[robot].sensors;
   for (auto sensor = msg->sensors.begin(), end = msg->sensors.end(); sensor != end; ++sensor)
   {
     const std::string &channel = sensor->name;
-    auto range = sensors_.equal_range(channel);
+    auto range = sensors.equal_range(channel);
     for (auto s = range.first, range_end = range.second; s != range_end; ++s) {
-      s->second->update(ros::Time::now(), sensor->values);
+      s->second->update(now, sensor->values);
     }
   }
 }
 
+static float period(float rate)
+{
+  return rate > 0 ? 1.0 / rate : 0.0;
+}
+
 void TactileStateDisplay::update(float wall_dt, float ros_dt)
 {
   if (!this->isEnabled()) return;
@@ -343,16 +672,41 @@ void TactileStateDisplay::update(float wall_dt, float ros_dt)
     // ros::Time::now was smaller than ros::Duration
   }
 
+  rviz::ViewController *view = context_->getViewManager()->getCurrent();
+  const Ogre::Camera *camera = view ? view->getCamera() : 0;
+  const float lod_threshold = lod_threshold_property_->getFloat();
+
+  const bool paused = pause_property_->getBool();
+  ros::Time replay_stamp = history_end_;
+  try {
+    replay_stamp -= ros::Duration(history_offset_property_->getFloat());
+  } catch (const std::runtime_error &e) {
+    replay_stamp = ros::Time();
+  }
+
+  const float color_period = period(refresh_rate_property_->getFloat());
+  const float property_period = period(property_rate_property_->getFloat());
+
   for (auto it = sensors_.begin(), end = sensors_.end(); it != end; ++it) {
     TactileVisualBase &sensor = *it->second;
-    sensor.updateRangeProperty();
+    bool colors_due = sensor.colorRate().tick(wall_dt, color_period);
+    if (colors_due)
+      sensor.consume();  // fetch latest readings from ingest thread
+    if (sensor.propertyRate().tick(wall_dt, property_period)) {
+      sensor.updateRangeProperty();
+      if (&sensor == selection_.sensor) updateSelection();
+    }
     if (!sensor.isVisible()) continue;
 
-    bool enabled = !sensor.expired(timeout) && sensor.updatePose();
+    bool enabled = (paused || !sensor.expired(timeout)) && sensor.updatePose();
     sensor.setEnabled(enabled);
     if (!enabled) continue;
 
-    sensor.update();
+    sensor.updateLOD(camera, lod_threshold);
+    if (!colors_due) continue;
+    if (paused) sensor.replay(replay_stamp);
+    // skip sensors without new data
+    else if (sensor.isDirty()) sensor.update();
   }
 }
 
@@ -33,14 +33,25 @@
 
 #include <map>
 #include <rviz/display.h>
+#include <ros/callback_queue.h>
+#include <ros/spinner.h>
 #include <tactile_msgs/TactileState.h>
 #include <tactile_filters/TactileValue.h>
+#include <urdf/sensor.h>
+#include <urdf_tactile/tactile.h>
 #include "color_map.h"
+#include "geometry_cache.h"
+
+namespace Ogre
+{
+class Ray;
+}
 
 namespace rviz
 {
 class Property;
 class StringProperty;
+class IntProperty;
 class BoolProperty;
 class ColorProperty;
 class FloatProperty;
@@ -52,6 +63,7 @@ namespace tactile
 
 class TactileVisualBase;
 class GroupProperty;
+typedef boost::shared_ptr<const urdf::SensorMap> SensorMapConstPtr;
 
 class TactileStateDisplay : public rviz::Display
 {
@@ -63,6 +75,19 @@ public:
 
   void resetTactile();
 
+  /// taxel hit by a ray
+  struct TaxelPick {
+    TaxelPick() : sensor(0), taxel(0), distance(0) {}
+    TactileVisualBase *sensor;
+    std::string channel;
+    size_t taxel;
+    float distance;
+  };
+  /// find visible taxel hit first by ray (in world coordinates), returns false if there is none
+  bool pick(const Ogre::Ray &ray, TaxelPick &result) const;
+  /// show taxel in selection properties, pick.sensor == 0 clears selection
+  void select(const TaxelPick &pick);
+
 protected:
   void subscribe();
   void unsubscribe();
@@ -74,21 +99,31 @@ protected:
   void onDisable();
   void update(float wall_dt, float ros_dt);
 
-  void processMessage(const tactile_msgs::TactileState::ConstPtr& msg);
+  void processMessage(const tactile_msgs::TactileState::ConstPtr& msg, size_t robot);
   GroupProperty *getGroupProperty(const QString &path, GroupProperty *parent);
+  /// create visual for a tactile sensor, sharing geometry with prototype if possible
+  TactileVisualBase *createVisual(const std::string &name, const urdf::Sensor &sensor,
+                                  const urdf::tactile::TactileSensor &tactile,
+                                  const TactileVisualBase *prototype);
+  /// update selection properties from selected taxel
+  void updateSelection();
 
 protected Q_SLOTS:
   void onTopicChanged();
   void onRobotDescriptionChanged();
+  void onRobotsChanged();
   void onTFPrefixChanged();
   void onModeChanged();
   void onModeParamsChanged();
   void onAllVisibleChanged();
+  void onHistoryChanged();
+  void onPauseChanged();
 
 private:
   rviz::RosTopicProperty* topic_property_;
   rviz::StringProperty* robot_description_property_;
   rviz::StringProperty* tf_prefix_property_;
+  rviz::IntProperty* robots_property_;
 
   rviz::EnumProperty* mode_property_;
   rviz::FloatProperty* mean_lambda_property_;
@@ -96,14 +131,44 @@ private:
   rviz::FloatProperty* release_decay_property_;
 
   rviz::FloatProperty* timeout_property_;
+  rviz::FloatProperty* refresh_rate_property_;
+  rviz::FloatProperty* property_rate_property_;
+  rviz::BoolProperty* batch_property_;
+  rviz::FloatProperty* lod_threshold_property_;
+  rviz::EnumProperty* array_mode_property_;
+  rviz::FloatProperty* history_budget_property_;
+  rviz::BoolProperty* history_quantize_property_;
+  rviz::BoolProperty* pause_property_;
+  rviz::FloatProperty* history_offset_property_;
+  rviz::StringProperty* selection_property_;
+  rviz::IntProperty* selection_index_property_;
+  rviz::StringProperty* selection_channel_property_;
+  rviz::FloatProperty* selection_raw_property_;
+  rviz::FloatProperty* selection_filtered_property_;
   GroupProperty* sensors_property_;
 
+  ros::CallbackQueue queue_;  /// ingest queue, served by spinner_
+  ros::AsyncSpinner spinner_;  /// ingest thread
   ros::NodeHandle  nh_;
-  ros::Subscriber  sub_;
-  /// list of all sensors, accessible by sensor name
+
+  /// robot instance sharing the robot description with other ones
+  struct Robot {
+    rviz::Property *property;  /// parent property of topic and tf_prefix (0 for first robot)
+    rviz::RosTopicProperty *topic;
+    rviz::StringProperty *tf_prefix;
+    ros::Subscriber sub;
+    /// sensors of this robot, accessible by channel
+    std::multimap<std::string, TactileVisualBase*> sensors;
+  };
+  std::vector<Robot> robots_;
+  /// list of all sensors (of all robots), accessible by channel
   std::multimap<std::string, TactileVisualBase*> sensors_;
+  SensorMapConstPtr model_;  /// parsed sensor descriptions (shared between displays)
 
   ::tactile::TactileValue::Mode mode_;
+  ros::Time history_end_;  /// most recent snapshot when paused
+  TaxelPick selection_;  /// selected taxel
+  GeometryCachePtr geometry_cache_;  /// keep shared taxel meshes and materials across sensor rebuilds
   ColorMap abs_color_map_;
   ColorMap rel_color_map_;
 };
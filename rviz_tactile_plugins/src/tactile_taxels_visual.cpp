@@ -30,18 +30,20 @@
  */
 
 #include "tactile_taxels_visual.h"
+#include "taxels_mesh.h"
+#include "geometry_cache.h"
+#include "color_map.h"
 
-#include <rviz/mesh_loader.h>
 #include <rviz/display_context.h>
-#include <rviz/ogre_helpers/shape.h>
 #include <rviz/ogre_helpers/arrow.h>
 #include <rviz/properties/float_property.h>
 #include <ros/console.h>
 
 #include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
 #include <OgreEntity.h>
-#include <OgreMaterialManager.h>
-#include <OgreTechnique.h>
+#include <OgreCamera.h>
+#include <OgreViewport.h>
 
 using namespace urdf::tactile;
 
@@ -51,141 +53,84 @@ namespace tactile {
 class TaxelEntity {
 public:
   TaxelEntity(const urdf::Geometry &geometry, const urdf::Pose& origin,
-              rviz::DisplayContext *context, Ogre::SceneNode *parent_node);
+              rviz::DisplayContext *context, Ogre::SceneNode *parent_node,
+              const GeometryCachePtr &cache);
   ~TaxelEntity();
-  void setColor(float r, float g, float b, float a);
+  void setColor(Ogre::uint32 abgr);
+  /// bounding box w.r.t. parent node
+  Ogre::AxisAlignedBox bounds() const;
 
 protected:
   Ogre::Entity *createEntityFromGeometry(const urdf::Geometry &geom, const urdf::Pose &origin);
 
   Ogre::SceneManager *scene_manager_;
   Ogre::SceneNode *taxel_node_;  // scene node all taxels are attached to
+  GeometryCachePtr cache_;  // shared meshes and materials
 
   Ogre::Entity *entity_;
-  Ogre::MaterialPtr material_;
 };
 
 TaxelEntity::TaxelEntity(const urdf::Geometry &geometry, const urdf::Pose& origin,
-                         rviz::DisplayContext *context, Ogre::SceneNode *parent_node)
+                         rviz::DisplayContext *context, Ogre::SceneNode *parent_node,
+                         const GeometryCachePtr &cache)
    : scene_manager_(context->getSceneManager())
    , taxel_node_(parent_node->createChildSceneNode())
+   , cache_(cache)
 {
-  // create material for coloring links
-  std::stringstream ss;
-  static int count = 0;
-  ss << "taxel color material " << count;
-  material_ = Ogre::MaterialPtr(new Ogre::Material(nullptr, Ogre::String(), 0, Ogre::String()));
-  material_->setReceiveShadows(false);
-
   entity_ = createEntityFromGeometry(geometry, origin);
-  setColor(0, 0, 0, 0);
+  setColor(0);
 }
 
 TaxelEntity::~TaxelEntity() {
-  scene_manager_->destroyEntity(entity_);
+  if (entity_) scene_manager_->destroyEntity(entity_);
   scene_manager_->destroySceneNode(taxel_node_);
 }
 
 Ogre::Entity* TaxelEntity::createEntityFromGeometry(const urdf::Geometry& geom, const urdf::Pose& origin)
 {
-  Ogre::Entity *entity = NULL; // default in case nothing works.
-  Ogre::SceneNode* offset_node = taxel_node_->createChildSceneNode();
-
-  static int count = 0;
-  std::stringstream ss;
-  ss << "taxel" << count++;
-  std::string entity_name = ss.str();
+  TaxelShape shape;
+  if (!getTaxelShape(geom, shape)) return NULL;
 
-  Ogre::Vector3 scale(Ogre::Vector3::UNIT_SCALE);
-  Ogre::Vector3 position(origin.position.x, origin.position.y, origin.position.z);
-  Ogre::Quaternion orientation(origin.rotation.w, origin.rotation.x, origin.rotation.y, origin.rotation.z);
-
-  switch (geom.type)
-  {
-  case urdf::Geometry::SPHERE:
-  {
-    const urdf::Sphere& sphere = static_cast<const urdf::Sphere&>(geom);
-    entity = rviz::Shape::createEntity(entity_name, rviz::Shape::Sphere, scene_manager_);
-
-    scale = Ogre::Vector3(sphere.radius*2, sphere.radius*2, sphere.radius*2);
-    break;
-  }
-  case urdf::Geometry::BOX:
-  {
-    const urdf::Box& box = static_cast<const urdf::Box&>(geom);
-    entity = rviz::Shape::createEntity(entity_name, rviz::Shape::Cube, scene_manager_);
+  Ogre::MeshPtr mesh = GeometryCache::mesh(shape.mesh);
+  if (mesh.isNull()) return NULL;
 
-    scale = Ogre::Vector3(box.dim.x, box.dim.y, box.dim.z);
-    break;
-  }
-  case urdf::Geometry::CYLINDER:
-  {
-    const urdf::Cylinder& cylinder = static_cast<const urdf::Cylinder&>(geom);
-
-    Ogre::Quaternion rotX;
-    rotX.FromAngleAxis( Ogre::Degree(90), Ogre::Vector3::UNIT_X );
-    orientation = orientation * rotX;
-
-    entity = rviz::Shape::createEntity(entity_name, rviz::Shape::Cylinder, scene_manager_);
-    scale = Ogre::Vector3(cylinder.radius*2, cylinder.length, cylinder.radius*2);
-    break;
-  }
-  case urdf::Geometry::MESH:
-  {
-    const urdf::Mesh& mesh = static_cast<const urdf::Mesh&>(geom);
-    if (mesh.filename.empty())
-      return entity;
-
-    scale = Ogre::Vector3(mesh.scale.x, mesh.scale.y, mesh.scale.z);
-    const std::string& model_name = mesh.filename;
-
-    loadMeshFromResource(model_name);
-    entity = scene_manager_->createEntity(entity_name, model_name);
-    break;
-  }
-  default:
-    ROS_WARN("Unsupported geometry type for element: %d", geom.type);
-    break;
-  }
-
-  if (entity)
-  {
-    offset_node->attachObject(entity);
-    offset_node->setScale(scale);
-    offset_node->setPosition(position);
-    offset_node->setOrientation(orientation);
-    entity->setMaterial(material_);
-  }
+  Ogre::Entity *entity = scene_manager_->createEntity(mesh);
+  Ogre::SceneNode* offset_node = taxel_node_->createChildSceneNode();
+  offset_node->attachObject(entity);
+  offset_node->setScale(shape.scale);
+  offset_node->setPosition(Ogre::Vector3(origin.position.x, origin.position.y, origin.position.z));
+  offset_node->setOrientation(Ogre::Quaternion(origin.rotation.w, origin.rotation.x,
+                                               origin.rotation.y, origin.rotation.z) * shape.orientation);
   return entity;
 }
 
-void TaxelEntity::setColor(float r, float g, float b, float a)
+void TaxelEntity::setColor(Ogre::uint32 abgr)
 {
-  Ogre::SceneBlendType blending;
-  bool depth_write;
-
-  if (a < 0.9998) {
-    blending = Ogre::SBT_TRANSPARENT_ALPHA;
-    depth_write = false;
-  } else {
-    blending = Ogre::SBT_REPLACE;
-    depth_write = true;
-  }
+  if (entity_) entity_->setMaterial(cache_->colorMaterial(abgr));
+}
 
-  Ogre::Technique* technique = material_->getTechnique(0);
-  technique->setAmbient(r*0.5, g*0.5, b*0.5);
-  technique->setDiffuse(r, g, b, a);
-  technique->setSceneBlending(blending);
-  technique->setDepthWriteEnabled(depth_write);
-  technique->setLightingEnabled(true);
+Ogre::AxisAlignedBox TaxelEntity::bounds() const
+{
+  if (!entity_) return Ogre::AxisAlignedBox(Ogre::Vector3::ZERO, Ogre::Vector3::ZERO);
+
+  const Ogre::Node *node = entity_->getParentNode();
+  Ogre::Matrix4 transform;
+  transform.makeTransform(node->getPosition(), node->getScale(), node->getOrientation());
+  Ogre::AxisAlignedBox box = entity_->getBoundingBox();
+  box.transformAffine(transform);
+  return box;
 }
 
 
 TactileTaxelsVisual::TactileTaxelsVisual(const std::string &name, const std::string &frame, const urdf::Pose &origin,
                                          const std::vector<TactileTaxelSharedPtr> &taxels,
                                          rviz::Display *owner, rviz::DisplayContext *context,
-                                         Ogre::SceneNode *parent_node, rviz::Property *parent_property)
+                                         Ogre::SceneNode *parent_node, rviz::Property *parent_property,
+                                         bool batched, const TactileTaxelsVisual *prototype)
   : TactileVisualBase(name, frame, origin, owner, context, parent_node, parent_property)
+  , cache_(GeometryCache::instance())
+  , mesh_(batched ? new TaxelsMesh() : 0)
+  , lod_level_(0), center_(Ogre::Vector3::ZERO)
 {
 #if ENABLE_ARROWS
   arrows_property_ = new rviz::BoolProperty
@@ -195,10 +140,14 @@ TactileTaxelsVisual::TactileTaxelsVisual(const std::string &name, const std::str
   arrows_node_ = scene_node_->createChildSceneNode();
 #endif
 
+  // share geometry of an identical sensor (of another robot)
+  const bool shared = mesh_ && prototype && prototype->mesh_;
   for (auto taxel = taxels.begin(), end = taxels.end(); taxel != end; ++taxel) {
     urdf::GeometryConstSharedPtr geometry = (*taxel)->geometry;
-    TaxelEntityPtr t(new TaxelEntity(*geometry, urdf::Pose(), context, scene_node_));
-    taxels_.push_back(t);
+    if (!mesh_)
+      taxels_.push_back(TaxelEntityPtr(new TaxelEntity(*geometry, urdf::Pose(), context, scene_node_, cache_)));
+    else if (!shared)
+      mesh_->addTaxel(*geometry, urdf::Pose());
     mapping_.push_back((*taxel)->idx);
 
 #if ENABLE_ARROWS
@@ -211,33 +160,154 @@ TactileTaxelsVisual::TactileTaxelsVisual(const std::string &name, const std::str
     arrows_.push_back(arrow);
 #endif
   }
-  values_.init(taxels_.size());
+  if (mesh_) {
+    if (shared)
+      mesh_->shareGeometry(*prototype->mesh_);
+    else
+      mesh_->finalize();
+    scene_node_->attachObject(mesh_);
+
+    if (shared) {
+      clusters_ = prototype->clusters_;
+    } else {
+      TaxelClusters *clusters = new TaxelClusters();
+      clusters->build(mesh_->centers());
+      clusters_.reset(clusters);
+    }
+    lod_level_ = clusters_->levels();
+    if (clusters_->levels())
+      center_ = clusters_->level(0).centers.front();
+    lod_meshes_.resize(clusters_->levels(), 0);
+  }
+
+  // spatial index for picking
+  if (shared) {
+    bvh_ = prototype->bvh_;
+  } else {
+    std::vector<Ogre::Vector3> min, max;
+    for (size_t i = 0, end = mapping_.size(); i != end; ++i) {
+      const Ogre::AxisAlignedBox box = mesh_ ? mesh_->bounds()[i] : taxels_[i]->bounds();
+      min.push_back(box.getMinimum());
+      max.push_back(box.getMaximum());
+    }
+    TaxelBVH *bvh = new TaxelBVH();
+    bvh->build(min, max);
+    bvh_.reset(bvh);
+  }
+  pipeline_.init(mapping_.size());
+  initSamples(mapping_.size());
+}
+
+TactileTaxelsVisual::~TactileTaxelsVisual()
+{
+  if (mesh_) {
+    scene_node_->detachObject(mesh_);
+    delete mesh_;
+  }
+  for (auto it = lod_meshes_.begin(), end = lod_meshes_.end(); it != end; ++it) {
+    if (!*it) continue;
+    scene_node_->detachObject(*it);
+    delete *it;
+  }
 }
 
 void TactileTaxelsVisual::update(const ros::Time &stamp, const sensor_msgs::ChannelFloat32::_values_type &values)
 {
   size_t N = values.size();
-  auto vit = values_.begin();
+  auto vit = raw_values_.begin();
   for (auto it = mapping_.begin(), end = mapping_.end(); it != end; ++it, ++vit) {
-    if (*it < N) vit->update(values[*it]);
-    else ROS_ERROR_STREAM("too short taxel msg for " << qPrintable(getName()));
+    if (*it >= N) {
+      ROS_ERROR_STREAM("too short taxel msg for " << qPrintable(getName()));
+      return;
+    }
+    *vit = values[*it];
   }
-  TactileVisualBase::update(stamp);
+  publish(stamp);
 }
 
-void TactileTaxelsVisual::update()
+void TactileTaxelsVisual::updateLOD(const Ogre::Camera *camera, float threshold)
 {
-  auto val_it = values_.begin();
-  for (auto it = taxels_.begin(), end = taxels_.end(); it != end; ++it, ++val_it) {
-    const QColor &c = mapColor(mapValue(*val_it));
-    (*it)->setColor(c.redF(), c.greenF(), c.blueF(), c.alphaF());
+  if (!mesh_ || clusters_->levels() == 0) return;
+
+  size_t level = clusters_->levels();  // full detail
+  const Ogre::Viewport *viewport = camera ? camera->getViewport() : 0;
+  if (threshold > 0 && viewport && viewport->getActualHeight() > 0) {
+    // size (in m) covering threshold pixels at the sensor's distance
+    const Ogre::Vector3 center = scene_node_->_getDerivedPosition() + scene_node_->_getDerivedOrientation() * center_;
+    const Ogre::Real distance = camera->getDerivedPosition().distance(center);
+    const Ogre::Real min_size = threshold * 2 * distance * Ogre::Math::Tan(camera->getFOVy() * 0.5)
+                                / viewport->getActualHeight();
+    if (mesh_->taxelSize() < min_size)
+      level = clusters_->select(min_size);
+  }
+  if (level == lod_level_) return;
+
+  if (lod_level_ < clusters_->levels())
+    lod_meshes_[lod_level_]->setVisible(false);
+  lod_level_ = level;
+  const bool clustered = level < clusters_->levels();
+  mesh_->setVisible(!clustered);
+  if (clustered)
+    lodMesh(level)->setVisible(true);
+  invalidate();  // enforce update of all colors
+}
+
+TaxelsMesh *TactileTaxelsVisual::lodMesh(size_t level)
+{
+  TaxelsMesh *&mesh = lod_meshes_[level];
+  if (mesh) return mesh;
+
+  // one box per cluster: geometry is static, only colors are updated later on
+  const TaxelClusters::Level &clusters = clusters_->level(level);
+  urdf::Box box;
+  box.dim = urdf::Vector3(clusters.cell_size, clusters.cell_size, clusters.cell_size);
+  mesh = new TaxelsMesh();
+  for (auto it = clusters.centers.begin(), end = clusters.centers.end(); it != end; ++it) {
+    urdf::Pose origin;
+    origin.position = urdf::Vector3(it->x, it->y, it->z);
+    mesh->addTaxel(box, origin);
+  }
+  mesh->finalize();
+  scene_node_->attachObject(mesh);
+  return mesh;
+}
+
+void TactileTaxelsVisual::updateClusterColors()
+{
+  const TaxelClusters::Level &clusters = clusters_->level(lod_level_);
+  const std::vector<float> &normalized = pipeline_.normalized();
+  TaxelsMesh *mesh = lod_meshes_[lod_level_];
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    // average normalized value of all taxels of the cluster
+    float sum = 0;
+    const unsigned int *begin = &clusters.members.front() + clusters.offsets[i];
+    const unsigned int *end = &clusters.members.front() + clusters.offsets[i+1];
+    for (const unsigned int *m = begin; m != end; ++m)
+      sum += normalized[*m];
+    mesh->setColor(i, mapColor(color_map_->index(sum / (end - begin))));
+  }
+  mesh->uploadColors();
+}
+
+void TactileTaxelsVisual::updateColors(const std::vector<unsigned int> &changed)
+{
+  if (mesh_ && lod_level_ < clusters_->levels()) {
+    updateClusterColors();
+  } else if (mesh_) {
+    for (auto it = changed.begin(), end = changed.end(); it != end; ++it)
+      mesh_->setColor(*it, mapColor(pipeline_.colorIndices()[*it]));
+    mesh_->uploadColors();
+  } else {
+    for (auto it = changed.begin(), end = changed.end(); it != end; ++it) {
+      taxels_[*it]->setColor(mapColor(pipeline_.colorIndices()[*it]));
+    }
   }
 
 #if ENABLE_ARROWS
   float scale = arrows_scale_property_->getFloat();
-  val_it = values_.begin();
+  auto val_it = pipeline_.normalized().begin();
   for (auto it = arrows_.begin(), end = arrows_.end(); it != end; ++it, ++val_it) {
-    float value = mapValue(*val_it);
+    float value = *val_it;
     value = std::isfinite(value) ? value*scale : 0.0;
     (*it)->setScale(Ogre::Vector3(value, value, value));
   }
@@ -30,6 +30,8 @@
 #pragma once
 
 #include "tactile_visual_base.h"
+#include "geometry_cache.h"
+#include "taxel_clusters.h"
 #include <urdf_tactile/tactile.h>
 
 #define ENABLE_ARROWS 0
@@ -45,6 +47,7 @@ namespace tactile {
 
 class TaxelEntity;
 typedef boost::shared_ptr<TaxelEntity> TaxelEntityPtr;
+class TaxelsMesh;
 
 
 class TactileTaxelsVisual : public TactileVisualBase
@@ -54,11 +57,19 @@ public:
   TactileTaxelsVisual(const std::string &name, const std::string &frame, const urdf::Pose &origin,
                       const std::vector<urdf::tactile::TactileTaxelSharedPtr> &taxels,
                       rviz::Display *owner, rviz::DisplayContext *context,
-                      Ogre::SceneNode* parent_node, Property *parent_property=0);
+                      Ogre::SceneNode* parent_node, Property *parent_property=0,
+                      bool batched=false, const TactileTaxelsVisual *prototype=0);
+  ~TactileTaxelsVisual();
+
+  void updateLOD(const Ogre::Camera *camera, float threshold);
+  unsigned int dataIndex(size_t taxel) const {return mapping_[taxel];}
 
 protected:
   void update(const ros::Time &stamp, const sensor_msgs::ChannelFloat32::_values_type &values);
-  void update();
+  void updateColors(const std::vector<unsigned int> &changed);
+  void updateClusterColors();
+  /// batched boxes of all clusters of given level, created on first use
+  TaxelsMesh *lodMesh(size_t level);
 
 #if ENABLE_ARROWS
 protected Q_SLOTS:
@@ -68,7 +79,15 @@ protected Q_SLOTS:
 
 protected:
   std::vector<unsigned int> mapping_;  /// mapping raw data indeces to taxels_
+  GeometryCachePtr cache_;  /// shared meshes and materials
   std::vector<TaxelEntityPtr> taxels_;
+  TaxelsMesh *mesh_;  /// batched rendering of all taxels (alternative to taxels_)
+
+  // level of detail (only available for batched rendering)
+  boost::shared_ptr<const TaxelClusters> clusters_;  /// clustering hierarchy of taxels, shared among robots
+  size_t lod_level_;  /// rendered cluster level, clusters_->levels() for full detail
+  Ogre::Vector3 center_;  /// center of all taxels
+  std::vector<TaxelsMesh*> lod_meshes_;  /// rendering of clusters for each level
 
 #if ENABLE_ARROWS
   rviz::BoolProperty *arrows_property_;
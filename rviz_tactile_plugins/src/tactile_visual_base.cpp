@@ -52,10 +52,10 @@ TactileVisualBase::TactileVisualBase(const std::string &name,
                                      Ogre::SceneNode *parent_node, rviz::Property *parent_property)
   : GroupProperty(QString::fromStdString(name), true, "", parent_property)
   , owner_(owner), context_(context), scene_node_(parent_node->createChildSceneNode())
-  , frame_(frame)
+  , frame_(frame), hash_(0), resolved_frame_(frame)
+  , generation_(0), rendered_generation_(0), dirty_(true)
+  , recording_(true)
   , color_map_(0)
-  , mode_(::tactile::TactileValue::rawCurrent)
-  , acc_mode_(::tactile::TactileValueArray::Sum), acc_mean_(true)
   , enabled_(false)
 {
   pose_.position.x = origin.position.x;
@@ -82,49 +82,145 @@ TactileVisualBase::~TactileVisualBase()
 void TactileVisualBase::setColorMap(const ColorMap *color_map)
 {
   color_map_ = color_map;
+  invalidate();
 }
 
 void TactileVisualBase::setMode(::tactile::TactileValue::Mode mode)
 {
-  mode_ = mode;
+  pipeline_.setMode(mode);
+  invalidate();
 }
 
 void TactileVisualBase::setAccumulationMode(::tactile::TactileValueArray::AccMode mode, bool mean)
 {
-  acc_mode_ = mode;
-  acc_mean_ = mean;
+  pipeline_.setAccumulationMode(mode, mean);
+}
+
+void TactileVisualBase::setMeanLambda(float fLambda)
+{
+  boost::lock_guard<boost::mutex> lock(ingest_mutex_);
+  ingest_.setMeanLambda(fLambda);
+}
+
+void TactileVisualBase::setRangeLambda(float fLambda)
+{
+  boost::lock_guard<boost::mutex> lock(ingest_mutex_);
+  ingest_.setRangeLambda(fLambda);
+}
+
+void TactileVisualBase::setReleaseDecay(float fDecay)
+{
+  boost::lock_guard<boost::mutex> lock(ingest_mutex_);
+  ingest_.setReleaseDecay(fDecay);
 }
 
 void TactileVisualBase::setTFPrefix(const std::string &tf_prefix)
 {
 	tf_prefix_ = tf_prefix;
+	resolved_frame_ = tf_prefix_.empty() ? frame_ : tf::resolve(tf_prefix_, frame_);
+}
+
+uint32_t TactileVisualBase::mapColor(unsigned int index) const
+{
+  return color_map_->rgba(index);
 }
 
-float TactileVisualBase::mapValue(const ::tactile::TactileValue &value)
+void TactileVisualBase::initSamples(size_t num)
 {
-  float v = value.value(mode_);
-  // normalize to range 0..1
-  if (mode_ == ::tactile::TactileValue::rawCurrent ||
-      mode_ == ::tactile::TactileValue::rawMean) {
-    v = (v - raw_range_.min()) / raw_range_.range();
+  raw_values_.assign(num, 0);
+  ingest_.init(num);
+  const TactilePipeline &ingest = ingest_;
+  samples_.forEach([&ingest](Sample &sample) {
+    sample.values = ingest.values();
+    sample.raw_range = ingest.rawRange();
+  });
+}
+
+void TactileVisualBase::publish(const ros::Time &stamp)
+{
+  Sample &sample = samples_.writeBuffer();
+  {
+    boost::lock_guard<boost::mutex> lock(ingest_mutex_);
+    // filter every message, such that filter constants refer to the message rate
+    ingest_.update(raw_values_);
+    sample.values = ingest_.values();
+    sample.raw_range = ingest_.rawRange();
   }
-  return v;
+  sample.stamp = stamp;
+  samples_.publish();
 }
 
-QColor TactileVisualBase::mapColor(float v)
+bool TactileVisualBase::consume()
 {
-  static QColor errColor("magenta");
-  if (!std::isfinite(v)) return errColor;
+  if (!samples_.consume()) return false;
+
+  const Sample &sample = samples_.readBuffer();
+  pipeline_.assign(sample.values, sample.raw_range);
+  last_update_time_ = sample.stamp;
+  ++generation_;
 
-  QColor color = color_map_->map(v);
-  return color;
+  if (recording_ && history_.capacity()) {
+    pipeline_.normalize();
+    history_.append(sample.stamp, pipeline_.normalized().data());
+  }
+  return true;
 }
 
-void TactileVisualBase::update(const ros::Time &stamp)
+void TactileVisualBase::updateColorIndices()
 {
-  last_update_time_ = stamp;
-  for (auto it = values_.begin(), end = values_.end(); it != end; ++it)
-    raw_range_.update(it->absRange());
+  const std::vector<unsigned int> &changed = pipeline_.quantize(*color_map_, dirty_);
+  if (!changed.empty())
+    updateColors(changed);
+  dirty_ = false;
+}
+
+void TactileVisualBase::update()
+{
+  pipeline_.normalize();
+  updateColorIndices();
+  rendered_generation_ = generation_;
+}
+
+void TactileVisualBase::initHistory(size_t capacity, bool quantized)
+{
+  history_.init(pipeline_.size(), capacity, quantized);
+}
+
+bool TactileVisualBase::replay(const ros::Time &stamp)
+{
+  size_t index;
+  if (!history_.find(stamp, index)) return false;
+
+  const ros::Time &snapshot = history_.stamp(index);
+  if (snapshot == replayed_stamp_ && !dirty_) return true;  // already shown
+  replayed_stamp_ = snapshot;
+
+  // replay via same color path as live data
+  std::vector<float> &normalized = pipeline_.normalized();
+  normalized.resize(pipeline_.size());
+  history_.get(index, normalized.data());
+  updateColorIndices();
+  return true;
+}
+
+bool TactileVisualBase::pick(const Ogre::Ray &ray, size_t &taxel, float &distance) const
+{
+  if (!bvh_ || bvh_->empty()) return false;
+  // transform ray into sensor frame
+  const Ogre::Quaternion inv = scene_node_->_getDerivedOrientation().Inverse();
+  const Ogre::Ray local(inv * (ray.getOrigin() - scene_node_->_getDerivedPosition()),
+                        inv * ray.getDirection());
+  return bvh_->intersect(local, taxel, distance);
+}
+
+float TactileVisualBase::rawValue(size_t taxel)
+{
+  return pipeline_.rawValue(taxel);
+}
+
+float TactileVisualBase::filteredValue(size_t taxel)
+{
+  return pipeline_.filteredValue(taxel);
 }
 
 bool TactileVisualBase::expired(const ros::Time &timeout) const
@@ -134,34 +230,41 @@ bool TactileVisualBase::expired(const ros::Time &timeout) const
 
 bool TactileVisualBase::updatePose()
 {
+  // FrameManager caches the most recent transform of each frame: sensors of the same link share it
   Ogre::Vector3 pos;
   Ogre::Quaternion quat;
-  const std::string& frame = tf_prefix_.empty() ? frame_ : tf::resolve(tf_prefix_, frame_);
-  if (!context_->getFrameManager()->transform(frame, ros::Time(), pose_, pos, quat))
+  if (!context_->getFrameManager()->getTransform(resolved_frame_, ros::Time(), pos, quat))
   {
     std::string error;
-	 context_->getFrameManager()->transformHasProblems(frame, ros::Time(), error);
+	 context_->getFrameManager()->transformHasProblems(resolved_frame_, ros::Time(), error);
     owner_->setStatusStd(rviz::StatusProperty::Error, getNameStd(), error);
     return false;
   }
   owner_->setStatus(rviz::StatusProperty::Ok, getName(), "");
-  scene_node_->setPosition(pos);
-  scene_node_->setOrientation(quat);
+
+  // apply sensor origin
+  Ogre::Quaternion rel_quat(pose_.orientation.w, pose_.orientation.x, pose_.orientation.y, pose_.orientation.z);
+  rel_quat.normalise();
+  scene_node_->setPosition(pos + quat * Ogre::Vector3(pose_.position.x, pose_.position.y, pose_.position.z));
+  scene_node_->setOrientation(quat * rel_quat);
   return true;
 }
 
 void TactileVisualBase::setRawRangeFromProperty()
 {
-  float fmin = range_property_->min(), fmax = range_property_->max();
-  for (auto &&v : values_)
-    v.init(fmin, fmax);
-  raw_range_.init(fmin, fmax);
+  const float min = range_property_->min(), max = range_property_->max();
+  {
+    boost::lock_guard<boost::mutex> lock(ingest_mutex_);
+    ingest_.setRawRange(min, max);
+  }
+  pipeline_.setRawRange(min, max);
+  invalidate();
 }
 
 void TactileVisualBase::updateRangeProperty()
 {
-  range_property_->update(raw_range_);
-  float value = values_.accumulate(mode_, acc_mode_, acc_mean_);
+  range_property_->update(pipeline_.rawRange());
+  float value = pipeline_.accumulated();
   if (value > -FLT_MAX && value < FLT_MAX)
     acc_value_property_->setFloat(value);
   else
@@ -170,7 +273,11 @@ void TactileVisualBase::updateRangeProperty()
 
 void TactileVisualBase::reset()
 {
-  values_.reset();
+  {
+    boost::lock_guard<boost::mutex> lock(ingest_mutex_);
+    ingest_.reset();
+  }
+  pipeline_.reset();
   range_property_->reset();
   setRawRangeFromProperty();
 }
@@ -30,17 +30,25 @@
 #pragma once
 
 #include "group_property.h"
+#include "triple_buffer.h"
+#include "rate_limiter.h"
+#include "tactile_history.h"
+#include "taxel_bvh.h"
+#include "tactile_pipeline.h"
 #include <urdf_tactile/tactile.h>
 #include <tactile_msgs/TactileState.h>
 #include <geometry_msgs/Pose.h>
 #include <tactile_filters/TactileValueArray.h>
 #include <tactile_filters/TactileValue.h>
 #include <ros/time.h>
-#include <QColor>
+#include <boost/thread/mutex.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
 
 namespace Ogre
 {
 class SceneNode;
+class Camera;
 }
 
 namespace rviz {
@@ -70,14 +78,42 @@ public:
 
   Qt::ItemFlags getViewFlags(int column) const;
 
-  /// update data buffer from new readings
+  /// pass new readings to the render thread (called from ingest thread)
   virtual void update(const ros::Time &stamp, const sensor_msgs::ChannelFloat32::_values_type &values) = 0;
+  /// fetch most recent readings passed by update(), returns false if there are none
+  bool consume();
   /// update sensor's scene_node_
   bool updatePose();
-  /// update min/max properties from raw_range_
+  /// choose level of detail, such that rendered elements cover at least threshold pixels
+  virtual void updateLOD(const Ogre::Camera *camera, float threshold) {}
+  /// update min/max properties from raw range
   void updateRangeProperty();
-  /// update taxels
-  virtual void update() = 0;
+  /// update colors of all taxels changed since last update()
+  void update();
+
+  /// anything changed since last update()?
+  bool isDirty() const {return dirty_ || generation_ != rendered_generation_;}
+  /// enforce an update of all taxel colors on next update()
+  void invalidate() {dirty_ = true;}
+
+  /// number of taxels
+  size_t numTaxels() const {return pipeline_.size();}
+  /// allocate history for capacity snapshots (discarding all recorded ones)
+  void initHistory(size_t capacity, bool quantized);
+  /// record snapshots of (normalized) values into history on consume()?
+  void setRecording(bool recording) {recording_ = recording;}
+  const TactileHistory &history() const {return history_;}
+  /// update colors from most recent snapshot not newer than stamp, returns false if there is none
+  bool replay(const ros::Time &stamp);
+
+  /// find taxel hit first by ray (in world coordinates), returns false if there is none
+  bool pick(const Ogre::Ray &ray, size_t &taxel, float &distance) const;
+  /// index of taxel within sensor data
+  virtual unsigned int dataIndex(size_t taxel) const {return taxel;}
+  /// raw value of taxel
+  float rawValue(size_t taxel);
+  /// value of taxel w.r.t. current display mode
+  float filteredValue(size_t taxel);
 
   /// reset ranges
   virtual void reset();
@@ -93,15 +129,23 @@ public:
   void setColorMap(const ColorMap* color_map);
   void setMode(::tactile::TactileValue::Mode mode);
   void setAccumulationMode(::tactile::TactileValueArray::AccMode mode, bool mean);
-  void setMeanLambda (float fLambda) {values_.setMeanLambda(fLambda);}
-  void setRangeLambda (float fLambda) {values_.setRangeLambda(fLambda);}
-  void setReleaseDecay (float fDecay) {values_.setReleaseDecay(fDecay);}
+  void setMeanLambda (float fLambda);
+  void setRangeLambda (float fLambda);
+  void setReleaseDecay (float fDecay);
+
+  /// stagger throttled updates of this sensor w.r.t. other sensors, phase in [0,1)
+  void setUpdatePhase(float phase) {color_rate_.setPhase(phase); property_rate_.setPhase(phase);}
+  RateLimiter &colorRate() {return color_rate_;}
+  RateLimiter &propertyRate() {return property_rate_;}
 
   // accessor functions
   const QString &getGroup() const {return group_;}
   void  setGroup(const QString &group) {group_ = group;}
   const std::string &getLinkFrame() const {return frame_;}
   void  setTFPrefix(const std::string &tf_prefix);
+  /// hash of the sensor description this visual was created from
+  size_t hash() const {return hash_;}
+  void  setHash(size_t hash) {hash_ = hash;}
 
 public Q_SLOTS:
   virtual void onVisibleChanged();
@@ -109,9 +153,16 @@ public Q_SLOTS:
   void setEnabled(bool enabled);
 
 protected:
-  float mapValue(const::tactile::TactileValue &value);
-  QColor mapColor(float value);
-  void update(const ros::Time &stamp);
+  /// quantize normalized values and update colors of changed taxels
+  void updateColorIndices();
+  /// packed RGBA color of a quantized color index (see ColorMap::rgba)
+  uint32_t mapColor(unsigned int index) const;
+  /// initialize ingest filters and sample buffers for num taxels
+  void initSamples(size_t num);
+  /// filter raw_values_ and publish the result to the render thread
+  void publish(const ros::Time &stamp);
+  /// update colors of the given taxels from pipeline_.colorIndices()
+  virtual void updateColors(const std::vector<unsigned int> &changed) = 0;
 
 protected Q_SLOTS:
   void setRawRangeFromProperty();
@@ -124,21 +175,43 @@ protected:
   QString group_;  // display group
   std::string frame_;  // frame this sensor is attached to
   std::string tf_prefix_;
+  size_t hash_;  // hash of sensor description
+  std::string resolved_frame_;  // frame_ resolved w.r.t. tf_prefix_
   geometry_msgs::Pose pose_; // pose relative to this frame_
 
-  ::tactile::TactileValueArray values_;  /// tactile values
+  /// raw readings of the current message, to be filled by update() before publish()
+  std::vector<float> raw_values_;
+  /// filters updated by every message (ingest thread), independent of the render rate
+  TactilePipeline ingest_;
+  boost::mutex ingest_mutex_;  /// protects ingest_ against configuration from render thread
+
+  struct Sample {
+    ros::Time stamp;
+    ::tactile::TactileValueArray values;  /// filtered values
+    ::tactile::Range raw_range;
+  };
+  TripleBuffer<Sample> samples_;  /// filtered readings passed from ingest to render thread
+
+  TactilePipeline pipeline_;  /// normalization and color quantization of filtered values (render thread)
   ros::Time last_update_time_;
+  unsigned long generation_;  /// incremented on each data update
+  unsigned long rendered_generation_;  /// generation_ at last update()
+  bool dirty_;  /// enforce update of all taxels
 
-  const ColorMap *color_map_;
-  ::tactile::TactileValue::Mode mode_;
-  ::tactile::TactileValueArray::AccMode acc_mode_;
-  bool acc_mean_;
+  TactileHistory history_;  /// recent snapshots of normalized values
+  bool recording_;  /// record snapshots into history_?
+  ros::Time replayed_stamp_;  /// stamp of snapshot shown by replay()
 
-  ::tactile::Range raw_range_;
+  boost::shared_ptr<const TaxelBVH> bvh_;  /// spatial index of taxel bounds (w.r.t. scene_node_) for picking, shared among robots
+
+  const ColorMap *color_map_;
   RangeProperty *range_property_;
   rviz::FloatProperty *acc_value_property_;
 
   bool enabled_;
+
+  RateLimiter color_rate_;  /// throttling of color updates
+  RateLimiter property_rate_;  /// throttling of property updates
 };
 
 }
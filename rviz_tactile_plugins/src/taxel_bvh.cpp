@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "taxel_bvh.h"
+#include <algorithm>
+#include <limits>
+
+namespace rviz {
+namespace tactile {
+
+static const unsigned int LEAF_SIZE = 4;  // max number of taxels per leaf
+static const unsigned int MAX_DEPTH = 64;  // size of traversal stack
+
+void TaxelBVH::clear()
+{
+  nodes_.clear();
+  order_.clear();
+  min_.clear();
+  max_.clear();
+}
+
+void TaxelBVH::build(const std::vector<Ogre::Vector3> &min, const std::vector<Ogre::Vector3> &max)
+{
+  clear();
+  min_ = min;
+  max_ = max;
+  order_.resize(min_.size());
+  for (unsigned int i = 0; i < order_.size(); ++i)
+    order_[i] = i;
+
+  if (order_.empty()) return;
+  nodes_.reserve(2 * order_.size() / LEAF_SIZE + 1);
+  build(0, order_.size());
+}
+
+unsigned int TaxelBVH::build(unsigned int begin, unsigned int end)
+{
+  const unsigned int index = nodes_.size();
+  nodes_.push_back(Node());
+
+  Node node;
+  node.begin = begin;
+  node.end = end;
+  node.right = 0;
+  node.min = min_[order_[begin]];
+  node.max = max_[order_[begin]];
+  // bounds of box centers (scaled by 2) to choose the split axis
+  Ogre::Vector3 cmin = node.min + node.max, cmax = cmin;
+  for (unsigned int i = begin; i != end; ++i) {
+    const unsigned int t = order_[i];
+    node.min.makeFloor(min_[t]);
+    node.max.makeCeil(max_[t]);
+    const Ogre::Vector3 c = min_[t] + max_[t];
+    cmin.makeFloor(c);
+    cmax.makeCeil(c);
+  }
+
+  const Ogre::Vector3 extent = cmax - cmin;
+  const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+  if (end - begin > LEAF_SIZE && extent[axis] > 0) {
+    // split at median box center along longest axis
+    const unsigned int mid = begin + (end - begin) / 2;
+    std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end,
+                     [this, axis](unsigned int a, unsigned int b) {
+      return min_[a][axis] + max_[a][axis] < min_[b][axis] + max_[b][axis];
+    });
+    build(begin, mid);  // left child: index + 1
+    node.right = build(mid, end);
+  }
+  nodes_[index] = node;
+  return index;
+}
+
+/// slab test of ray (origin, 1/direction) against box, yielding entry distance t < max_t
+static inline bool hitBox(const Ogre::Vector3 &min, const Ogre::Vector3 &max,
+                          const Ogre::Vector3 &origin, const Ogre::Vector3 &inv_dir,
+                          float max_t, float &t)
+{
+  float t0 = 0, t1 = max_t;
+  for (int a = 0; a < 3; ++a) {
+    float near = (min[a] - origin[a]) * inv_dir[a];
+    float far = (max[a] - origin[a]) * inv_dir[a];
+    if (near > far) std::swap(near, far);
+    // written such that NaNs (ray parallel and within slab) don't shrink the interval
+    t0 = near > t0 ? near : t0;
+    t1 = far < t1 ? far : t1;
+    if (t0 > t1) return false;
+  }
+  t = t0;
+  return true;
+}
+
+bool TaxelBVH::intersect(const Ogre::Ray &ray, size_t &taxel, float &distance) const
+{
+  if (nodes_.empty()) return false;
+
+  const Ogre::Vector3 &origin = ray.getOrigin();
+  const Ogre::Vector3 &dir = ray.getDirection();
+  const Ogre::Vector3 inv_dir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+  float best = std::numeric_limits<float>::infinity();
+  float t, t_left, t_right;
+  bool found = false;
+  if (!hitBox(nodes_[0].min, nodes_[0].max, origin, inv_dir, best, t)) return false;
+
+  unsigned int stack[MAX_DEPTH];
+  unsigned int top = 0;
+  stack[top++] = 0;
+  while (top) {
+    const unsigned int index = stack[--top];
+    const Node &node = nodes_[index];
+    if (!node.right) {  // leaf: test individual taxels
+      for (unsigned int i = node.begin; i != node.end; ++i) {
+        const unsigned int k = order_[i];
+        if (hitBox(min_[k], max_[k], origin, inv_dir, best, t)) {
+          best = t;
+          taxel = k;
+          found = true;
+        }
+      }
+      continue;
+    }
+
+    // descend into children hit before best, nearer one first
+    const unsigned int left = index + 1, right = node.right;
+    const bool hit_left = hitBox(nodes_[left].min, nodes_[left].max, origin, inv_dir, best, t_left);
+    const bool hit_right = hitBox(nodes_[right].min, nodes_[right].max, origin, inv_dir, best, t_right);
+    if (hit_left && hit_right) {
+      const bool left_first = t_left <= t_right;
+      stack[top++] = left_first ? right : left;
+      stack[top++] = left_first ? left : right;
+    } else if (hit_left) {
+      stack[top++] = left;
+    } else if (hit_right) {
+      stack[top++] = right;
+    }
+  }
+  if (found) distance = best;
+  return found;
+}
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <OgreVector3.h>
+#include <OgreRay.h>
+#include <vector>
+
+namespace rviz {
+namespace tactile {
+
+/** Bounding volume hierarchy over the axis-aligned bounding boxes of taxels.
+ *
+ *  Used to pick individual taxels via ray casting, independently of how taxels are rendered
+ *  (batched meshes, point clouds, textures), which renders Ogre's per-entity selection useless.
+ *  The hierarchy is a binary tree of boxes, split at the median of the longest axis,
+ *  and stored in depth-first order: the left child of node i is node i+1.
+ */
+class TaxelBVH
+{
+public:
+  TaxelBVH() {}
+  /// build hierarchy over boxes (min[i], max[i]) of all taxels
+  void build(const std::vector<Ogre::Vector3> &min, const std::vector<Ogre::Vector3> &max);
+  void clear();
+
+  /// number of taxels
+  size_t size() const {return min_.size();}
+  bool empty() const {return min_.empty();}
+
+  /// find taxel whose box is hit first by ray, returns false if there is none
+  bool intersect(const Ogre::Ray &ray, size_t &taxel, float &distance) const;
+
+private:
+  struct Node {
+    Ogre::Vector3 min, max;
+    unsigned int begin, end;  /// taxels of leaf node: order_[begin..end)
+    unsigned int right;       /// right child of inner node, 0 for leafs
+  };
+  unsigned int build(unsigned int begin, unsigned int end);
+
+  std::vector<Node> nodes_;
+  std::vector<unsigned int> order_;  /// taxel indices, sorted by leafs
+  std::vector<Ogre::Vector3> min_, max_;  /// taxel boxes
+};
+
+} // namespace tactile
+} // namespace rviz
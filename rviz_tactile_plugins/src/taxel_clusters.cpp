@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "taxel_clusters.h"
+#include <algorithm>
+#include <stdint.h>
+
+namespace rviz {
+namespace tactile {
+
+void TaxelClusters::build(const std::vector<Ogre::Vector3> &positions, unsigned int max_depth)
+{
+  levels_.clear();
+  if (positions.empty()) return;
+
+  Ogre::Vector3 min = positions.front(), max = min;
+  for (auto it = positions.begin(), end = positions.end(); it != end; ++it) {
+    min.makeFloor(*it);
+    max.makeCeil(*it);
+  }
+  const Ogre::Vector3 extent = max - min;
+  const float root_size = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f));
+
+  // taxel indices, sorted by cell key of current level
+  std::vector<std::pair<uint64_t, unsigned int> > keys(positions.size());
+  for (unsigned int depth = 0; depth <= max_depth; ++depth) {
+    const unsigned int cells = 1u << depth;
+    const float cell_size = root_size / cells;
+    for (unsigned int i = 0; i < positions.size(); ++i) {
+      const Ogre::Vector3 rel = (positions[i] - min) / cell_size;
+      uint64_t ix = std::min(cells - 1, static_cast<unsigned int>(rel.x));
+      uint64_t iy = std::min(cells - 1, static_cast<unsigned int>(rel.y));
+      uint64_t iz = std::min(cells - 1, static_cast<unsigned int>(rel.z));
+      keys[i] = std::make_pair((ix << 40) | (iy << 20) | iz, i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    levels_.push_back(Level());
+    Level &level = levels_.back();
+    level.cell_size = cell_size;
+    level.members.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const uint64_t key = keys[i].first;
+      if (i == 0 || key != keys[i-1].first) {
+        const Ogre::Vector3 cell((key >> 40) & 0xFFFFF, (key >> 20) & 0xFFFFF, key & 0xFFFFF);
+        level.centers.push_back(min + (cell + 0.5) * cell_size);
+        level.offsets.push_back(i);
+      }
+      level.members.push_back(keys[i].second);
+    }
+    level.offsets.push_back(keys.size());
+
+    // all taxels separated?
+    if (level.size() == positions.size()) break;
+  }
+}
+
+size_t TaxelClusters::select(float min_size) const
+{
+  for (size_t k = levels_.size(); k > 1; --k)
+    if (levels_[k-1].cell_size >= min_size)
+      return k-1;
+  return 0;
+}
+
+} // namespace tactile
+} // namespace rviz
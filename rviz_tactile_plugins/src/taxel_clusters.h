@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <OgreVector3.h>
+#include <vector>
+
+namespace rviz {
+namespace tactile {
+
+/** Octree-like clustering hierarchy over taxel positions used for level-of-detail rendering.
+ *
+ *  Level k partitions the bounding cube of all taxels into cells of size root_size / 2^k.
+ *  Each non-empty cell forms a cluster of taxels. Levels are refined until each cluster
+ *  holds a single taxel (or a maximum depth is reached).
+ */
+class TaxelClusters
+{
+public:
+  struct Level {
+    float cell_size;
+    std::vector<Ogre::Vector3> centers;  /// cell center of each cluster
+    std::vector<unsigned int> offsets;   /// members of cluster i: members[offsets[i]..offsets[i+1])
+    std::vector<unsigned int> members;   /// taxel indices
+    size_t size() const {return centers.size();}
+  };
+
+  TaxelClusters() {}
+  /// build hierarchy from taxel positions
+  void build(const std::vector<Ogre::Vector3> &positions, unsigned int max_depth = 10);
+
+  size_t levels() const {return levels_.size();}
+  const Level &level(size_t k) const {return levels_[k];}
+
+  /// finest level whose cells are at least min_size large (coarsest level 0 if there is none)
+  size_t select(float min_size) const;
+
+private:
+  std::vector<Level> levels_;
+};
+
+} // namespace tactile
+} // namespace rviz
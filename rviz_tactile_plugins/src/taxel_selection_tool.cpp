@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "taxel_selection_tool.h"
+#include "tactile_state_display.h"
+#include "tactile_visual_base.h"
+
+#include <rviz/display_context.h>
+#include <rviz/display_group.h>
+#include <rviz/viewport_mouse_event.h>
+
+#include <OgreCamera.h>
+#include <OgreViewport.h>
+#include <OgreRay.h>
+
+namespace rviz {
+namespace tactile {
+
+TaxelSelectionTool::TaxelSelectionTool()
+{
+}
+
+void TaxelSelectionTool::activate()
+{
+  setStatus("Move the mouse over taxels to inspect them, click to select one.");
+}
+
+void TaxelSelectionTool::deactivate()
+{
+}
+
+void TaxelSelectionTool::collectDisplays(rviz::DisplayGroup *group, std::vector<TactileStateDisplay*> &displays)
+{
+  for (int i = 0, end = group->numDisplays(); i != end; ++i) {
+    rviz::Display *display = group->getDisplayAt(i);
+    if (!display->isEnabled()) continue;
+    if (TactileStateDisplay *tactile = dynamic_cast<TactileStateDisplay*>(display))
+      displays.push_back(tactile);
+    else if (rviz::DisplayGroup *child = dynamic_cast<rviz::DisplayGroup*>(display))
+      collectDisplays(child, displays);
+  }
+}
+
+int TaxelSelectionTool::processMouseEvent(rviz::ViewportMouseEvent &event)
+{
+  if (!event.viewport || event.viewport->getActualWidth() <= 0 || event.viewport->getActualHeight() <= 0)
+    return 0;
+
+  const Ogre::Ray ray = event.viewport->getCamera()->getCameraToViewportRay
+      (static_cast<float>(event.x) / event.viewport->getActualWidth(),
+       static_cast<float>(event.y) / event.viewport->getActualHeight());
+
+  std::vector<TactileStateDisplay*> displays;
+  collectDisplays(context_->getRootDisplayGroup(), displays);
+
+  // find nearest taxel across all displays
+  TactileStateDisplay *hit_display = 0;
+  TactileStateDisplay::TaxelPick hit, pick;
+  for (auto it = displays.begin(), end = displays.end(); it != end; ++it) {
+    if (!(*it)->pick(ray, pick)) continue;
+    if (hit_display && pick.distance >= hit.distance) continue;
+    hit_display = *it;
+    hit = pick;
+  }
+
+  if (hit_display) {
+    setStatus(QString("%1: taxel %2 of channel %3, raw value: %4, filtered value: %5")
+              .arg(hit.sensor->getName()).arg(hit.sensor->dataIndex(hit.taxel))
+              .arg(QString::fromStdString(hit.channel))
+              .arg(hit.sensor->rawValue(hit.taxel)).arg(hit.sensor->filteredValue(hit.taxel)));
+  } else {
+    setStatus("No taxel under mouse cursor.");
+  }
+
+  if (event.leftUp()) {
+    for (auto it = displays.begin(), end = displays.end(); it != end; ++it)
+      (*it)->select(*it == hit_display ? hit : TactileStateDisplay::TaxelPick());
+  }
+  return 0;
+}
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <rviz/tool.h>
+#include <vector>
+
+namespace Ogre
+{
+class Ray;
+}
+
+namespace rviz
+{
+class DisplayGroup;
+
+namespace tactile
+{
+
+class TactileStateDisplay;
+
+/** Tool to inspect individual taxels of all TactileStateDisplays.
+ *
+ *  Hovering shows the taxel under the mouse cursor in the status bar,
+ *  clicking selects it in the "selected taxel" property of its display.
+ *  Taxels are picked by ray casting against each sensor's TaxelBVH,
+ *  which works independently of how taxels are rendered.
+ */
+class TaxelSelectionTool : public rviz::Tool
+{
+  Q_OBJECT
+public:
+  TaxelSelectionTool();
+
+  void activate();
+  void deactivate();
+  int processMouseEvent(rviz::ViewportMouseEvent &event);
+
+protected:
+  /// collect all enabled TactileStateDisplays within group (recursively)
+  static void collectDisplays(rviz::DisplayGroup *group, std::vector<TactileStateDisplay*> &displays);
+};
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "taxels_mesh.h"
+
+#include <OgreHardwareBufferManager.h>
+#include <OgreSceneNode.h>
+#include <OgreCamera.h>
+
+namespace rviz {
+namespace tactile {
+
+TaxelsMesh::TaxelsMesh()
+  : cache_(GeometryCache::instance())
+  , sum_sizes_(0), num_sized_(0)
+  , dirty_begin_(0), dirty_end_(0)
+  , num_translucent_(0)
+  , bounding_radius_(0)
+  , translucent_(true)
+{
+  taxel_vertices_.push_back(0);
+  mBox.setNull();
+  setTranslucent(false);
+
+  mRenderOp.vertexData = 0;
+  mRenderOp.indexData = 0;
+}
+
+TaxelsMesh::~TaxelsMesh()
+{
+  delete mRenderOp.vertexData;
+  delete mRenderOp.indexData;
+}
+
+bool TaxelsMesh::addTaxel(const urdf::Geometry &geom, const urdf::Pose &origin)
+{
+  TaxelShape shape;
+  bool valid = getTaxelShape(geom, shape);
+  Ogre::Vector3 position(origin.position.x, origin.position.y, origin.position.z);
+  Ogre::AxisAlignedBox box;
+  if (valid) {
+    Ogre::Quaternion orientation(origin.rotation.w, origin.rotation.x, origin.rotation.y, origin.rotation.z);
+    const GeometryCache::Geometry &geometry = cache_->geometry(shape.mesh);
+    valid = !geometry.vertices.empty();
+    const size_t first = vertices_.size();
+    appendGeometry(geometry, position, orientation * shape.orientation, shape.scale);
+    for (size_t i = first, end = vertices_.size(); i != end; ++i)
+      box.merge(vertices_[i].position);
+  }
+  if (box.isFinite()) {
+    centers_.push_back(box.getCenter());
+    const Ogre::Vector3 extent = box.getSize();
+    sum_sizes_ += std::max(extent.x, std::max(extent.y, extent.z));
+    ++num_sized_;
+    bounds_.push_back(box);
+  } else {
+    centers_.push_back(position);
+    bounds_.push_back(Ogre::AxisAlignedBox(position, position));
+  }
+
+  // always add a (possibly empty) vertex range to keep taxel indexing consistent
+  taxel_vertices_.push_back(vertices_.size());
+  return valid;
+}
+
+void TaxelsMesh::appendGeometry(const GeometryCache::Geometry &geometry, const Ogre::Vector3 &position,
+                                const Ogre::Quaternion &orientation, const Ogre::Vector3 &scale)
+{
+  const Ogre::uint32 offset = vertices_.size();
+  // normals need to be transformed with inverse scaling
+  const Ogre::Vector3 inv_scale(1.0 / scale.x, 1.0 / scale.y, 1.0 / scale.z);
+  for (auto it = geometry.vertices.begin(), end = geometry.vertices.end(); it != end; ++it) {
+    Vertex v;
+    v.position = position + orientation * (scale * it->position);
+    v.normal = orientation * (inv_scale * it->normal).normalisedCopy();
+    vertices_.push_back(v);
+    mBox.merge(v.position);
+    bounding_radius_ = std::max(bounding_radius_, v.position.length());
+  }
+  for (auto it = geometry.indices.begin(), end = geometry.indices.end(); it != end; ++it)
+    indices_.push_back(*it + offset);
+}
+
+void TaxelsMesh::finalize()
+{
+  createRenderOp(vertices_.size(), indices_.size());
+  if (vertices_.empty() || indices_.empty()) return;
+
+  Ogre::HardwareBufferManager &manager = Ogre::HardwareBufferManager::getSingleton();
+  Ogre::VertexData *vertex_data = mRenderOp.vertexData;
+  Ogre::IndexData *index_data = mRenderOp.indexData;
+
+  // static geometry buffer
+  Ogre::HardwareVertexBufferSharedPtr vbuf = manager.createVertexBuffer
+      (vertex_data->vertexDeclaration->getVertexSize(0), vertices_.size(), Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+  vbuf->writeData(0, vbuf->getSizeInBytes(), &vertices_.front(), true);
+  vertex_data->vertexBufferBinding->setBinding(0, vbuf);
+
+  index_data->indexBuffer = manager.createIndexBuffer
+      (Ogre::HardwareIndexBuffer::IT_32BIT, indices_.size(), Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+  index_data->indexBuffer->writeData(0, index_data->indexBuffer->getSizeInBytes(), &indices_.front(), true);
+
+  createColorBuffer();
+
+  // geometry is kept in hardware buffers only
+  std::vector<Vertex>().swap(vertices_);
+  std::vector<Ogre::uint32>().swap(indices_);
+}
+
+void TaxelsMesh::shareGeometry(const TaxelsMesh &prototype)
+{
+  taxel_vertices_ = prototype.taxel_vertices_;
+  centers_ = prototype.centers_;
+  bounds_ = prototype.bounds_;
+  sum_sizes_ = prototype.sum_sizes_;
+  num_sized_ = prototype.num_sized_;
+  mBox = prototype.mBox;
+  bounding_radius_ = prototype.bounding_radius_;
+
+  const Ogre::VertexData *vertex_data = prototype.mRenderOp.vertexData;
+  const Ogre::IndexData *index_data = prototype.mRenderOp.indexData;
+  createRenderOp(vertex_data ? vertex_data->vertexCount : 0, index_data ? index_data->indexCount : 0);
+  if (!vertex_data || !index_data || index_data->indexBuffer.isNull()) return;
+
+  // reference static buffers of prototype, only the color buffer is our own
+  mRenderOp.vertexData->vertexBufferBinding->setBinding(0, vertex_data->vertexBufferBinding->getBuffer(0));
+  mRenderOp.indexData->indexBuffer = index_data->indexBuffer;
+  createColorBuffer();
+}
+
+void TaxelsMesh::createRenderOp(size_t num_vertices, size_t num_indices)
+{
+  delete mRenderOp.vertexData;
+  delete mRenderOp.indexData;
+
+  mRenderOp.operationType = Ogre::RenderOperation::OT_TRIANGLE_LIST;
+  mRenderOp.useIndexes = true;
+
+  Ogre::VertexData *vertex_data = mRenderOp.vertexData = new Ogre::VertexData();
+  vertex_data->vertexStart = 0;
+  vertex_data->vertexCount = num_vertices;
+
+  Ogre::VertexDeclaration *decl = vertex_data->vertexDeclaration;
+  size_t offset = 0;
+  offset += decl->addElement(0, offset, Ogre::VET_FLOAT3, Ogre::VES_POSITION).getSize();
+  offset += decl->addElement(0, offset, Ogre::VET_FLOAT3, Ogre::VES_NORMAL).getSize();
+  decl->addElement(1, 0, Ogre::VET_COLOUR_ABGR, Ogre::VES_DIFFUSE);
+
+  Ogre::IndexData *index_data = mRenderOp.indexData = new Ogre::IndexData();
+  index_data->indexStart = 0;
+  index_data->indexCount = num_indices;
+
+  colors_.assign(num_vertices, 0);
+  // initial color (0) is fully transparent
+  num_translucent_ = 0;
+  for (size_t i = 0, end = size(); i != end; ++i)
+    num_translucent_ += (taxel_vertices_[i] != taxel_vertices_[i+1]);
+  dirty_begin_ = 0;
+  dirty_end_ = colors_.size();
+}
+
+void TaxelsMesh::createColorBuffer()
+{
+  // dynamic color buffer
+  Ogre::VertexData *vertex_data = mRenderOp.vertexData;
+  color_buffer_ = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer
+      (vertex_data->vertexDeclaration->getVertexSize(1), vertex_data->vertexCount,
+       Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+  vertex_data->vertexBufferBinding->setBinding(1, color_buffer_);
+  uploadColors();
+}
+
+static inline bool isTranslucent(Ogre::uint32 abgr) {
+  return (abgr >> 24) < 0xFF;
+}
+
+void TaxelsMesh::setColor(size_t idx, Ogre::uint32 abgr)
+{
+  const size_t begin = taxel_vertices_[idx], end = taxel_vertices_[idx+1];
+  if (begin == end) return;  // taxel without geometry
+
+  num_translucent_ += isTranslucent(abgr);
+  num_translucent_ -= isTranslucent(colors_[begin]);
+  std::fill(colors_.begin() + begin, colors_.begin() + end, abgr);
+
+  if (dirty_begin_ == dirty_end_) {
+    dirty_begin_ = begin;
+    dirty_end_ = end;
+  } else {
+    dirty_begin_ = std::min(dirty_begin_, begin);
+    dirty_end_ = std::max(dirty_end_, end);
+  }
+}
+
+void TaxelsMesh::uploadColors()
+{
+  if (color_buffer_.isNull() || dirty_begin_ == dirty_end_) return;
+
+  const size_t vertex_size = color_buffer_->getVertexSize();
+  const bool all = (dirty_begin_ == 0 && dirty_end_ == colors_.size());
+  color_buffer_->writeData(dirty_begin_ * vertex_size, (dirty_end_ - dirty_begin_) * vertex_size,
+                           &colors_[dirty_begin_], all);
+  dirty_begin_ = dirty_end_ = 0;
+
+  setTranslucent(num_translucent_ > 0);
+}
+
+void TaxelsMesh::setTranslucent(bool translucent)
+{
+  if (translucent == translucent_) return;
+  translucent_ = translucent;
+
+  setMaterial(cache_->vertexColorMaterial(translucent)->getName());
+}
+
+Ogre::Real TaxelsMesh::getSquaredViewDepth(const Ogre::Camera *cam) const
+{
+  return getParentNode()->getSquaredViewDepth(cam);
+}
+
+}
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "geometry_cache.h"
+#include <OgreSimpleRenderable.h>
+#include <OgreColourValue.h>
+#include <vector>
+
+namespace rviz {
+namespace tactile {
+
+/** Batched rendering of all taxels of a sensor.
+ *
+ *  The geometries of all taxels are merged into a single, static vertex buffer.
+ *  Colors are stored per vertex in a separate, dynamic vertex buffer, such that
+ *  a color update only needs to rewrite this small buffer.
+ *  Thus all taxels of a sensor are rendered with a single draw call.
+ */
+class TaxelsMesh : public Ogre::SimpleRenderable
+{
+public:
+  TaxelsMesh();
+  ~TaxelsMesh();
+
+  /// append a taxel's geometry (w.r.t. origin), returns false if geometry is not supported
+  bool addTaxel(const urdf::Geometry &geometry, const urdf::Pose &origin);
+  /// create hardware buffers from previously added taxels
+  void finalize();
+  /// reuse (static) geometry buffers of prototype instead of adding taxels
+  void shareGeometry(const TaxelsMesh &prototype);
+
+  /// number of taxels
+  size_t size() const {return taxel_vertices_.size() - 1;}
+  /// bounding box centers of all taxels
+  const std::vector<Ogre::Vector3> &centers() const {return centers_;}
+  /// bounding boxes of all taxels
+  const std::vector<Ogre::AxisAlignedBox> &bounds() const {return bounds_;}
+  /// average (maximum) extent of taxels
+  Ogre::Real taxelSize() const {return num_sized_ ? sum_sizes_ / num_sized_ : 0;}
+
+  /// set (packed ABGR) color of taxel idx in shadow buffer
+  void setColor(size_t idx, Ogre::uint32 abgr);
+  /// write modified part of shadow color buffer to hardware buffer
+  void uploadColors();
+
+  Ogre::Real getSquaredViewDepth(const Ogre::Camera *cam) const;
+  Ogre::Real getBoundingRadius() const {return bounding_radius_;}
+
+protected:
+  void appendGeometry(const GeometryCache::Geometry &geometry, const Ogre::Vector3 &position,
+                      const Ogre::Quaternion &orientation, const Ogre::Vector3 &scale);
+  void createRenderOp(size_t num_vertices, size_t num_indices);
+  void createColorBuffer();
+  void setTranslucent(bool translucent);
+
+protected:
+  typedef GeometryCache::Vertex Vertex;
+  GeometryCachePtr cache_;             /// shared geometries and materials
+  std::vector<Vertex> vertices_;       /// vertex data of all taxels
+  std::vector<Ogre::uint32> indices_;  /// triangle indices of all taxels
+  std::vector<size_t> taxel_vertices_; /// vertex range of taxel i: [taxel_vertices_[i], taxel_vertices_[i+1])
+  std::vector<Ogre::Vector3> centers_; /// bounding box center of taxel i
+  std::vector<Ogre::AxisAlignedBox> bounds_; /// bounding box of taxel i
+  Ogre::Real sum_sizes_;
+  size_t num_sized_;
+
+  std::vector<Ogre::uint32> colors_;   /// shadow color buffer (ABGR)
+  size_t dirty_begin_, dirty_end_;     /// modified vertex range of colors_
+  size_t num_translucent_;             /// number of taxels with alpha < 1
+  Ogre::HardwareVertexBufferSharedPtr color_buffer_;
+
+  Ogre::Real bounding_radius_;
+  bool translucent_;
+};
+
+}
+}
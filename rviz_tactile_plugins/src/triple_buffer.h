@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+namespace rviz {
+namespace tactile {
+
+/** Lock-free triple buffer to pass the latest data from a single producer to a single consumer.
+ *
+ *  The producer fills writeBuffer() and publish()es it. The consumer fetches the most recent,
+ *  published buffer via consume() and accesses it via readBuffer(). Both sides never block,
+ *  older, not yet consumed data is silently overwritten.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+  TripleBuffer() : middle_(1), write_(0), read_(2) {}
+
+  /// buffer to be filled by the producer
+  T& writeBuffer() {return buffers_[write_];}
+  /// pass the write buffer to the consumer, continuing with a fresh write buffer
+  void publish() {
+    write_ = middle_.exchange(write_ | FRESH, std::memory_order_acq_rel) & INDEX;
+  }
+
+  /// fetch the most recently published buffer, returns false if nothing new was published
+  bool consume() {
+    if (!(middle_.load(std::memory_order_acquire) & FRESH)) return false;
+    read_ = middle_.exchange(read_, std::memory_order_acq_rel) & INDEX;
+    return true;
+  }
+  /// buffer fetched by the last successful consume()
+  T& readBuffer() {return buffers_[read_];}
+
+  /// apply f to all buffers (only safe while neither producer nor consumer are active)
+  template <typename F>
+  void forEach(F f) {
+    for (unsigned int i = 0; i < 3; ++i)
+      f(buffers_[i]);
+  }
+
+private:
+  static const unsigned int INDEX = 3;
+  static const unsigned int FRESH = 4;
+
+  std::atomic<unsigned int> middle_;  /// index of middle buffer + FRESH flag
+  unsigned int write_;  /// index of write buffer (only accessed by producer)
+  unsigned int read_;  /// index of read buffer (only accessed by consumer)
+  T buffers_[3];
+};
+
+} // namespace tactile
+} // namespace rviz
@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "load_generator.h"
+
+#include <urdf/sensor.h>
+#include <urdf_tactile/tactile.h>
+#include <urdf_tactile/cast.h>
+#include <urdf_tactile/taxel_info_iterator.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace urdf::tactile;
+
+LoadGenerator::LoadGenerator():
+  publish_rate_(DEFAULT_PUBLISH_RATE),
+  patterns_(BLOBS), amplitude_(1.0), sparsity_(0.01), noise_amplitude_(0.1),
+  blob_sigma_(0.05), blob_speed_(0.5),
+  impact_rate_(1.0), impact_radius_(0.1), impact_duration_(0.2),
+  rng_state_(88172645463325252ull), missed_(0)
+{
+  config();
+  tactile_pub_ = nh_.advertise<tactile_msgs::TactileState>("tactile", 5);
+}
+
+void LoadGenerator::config()
+{
+  /* avoid throwing of two exceptions in a row:
+     Due to a bug in pluginlib, the unloading of the lib might throw on destruction of SensorParserMap.
+  */
+  try {
+    urdf::SensorParserMap parsers = urdf::getSensorParser("tactile");
+    createChannels(urdf::parseSensorsFromParam("robot_description", parsers));
+  } catch (const std::exception &e) {
+    ROS_ERROR_STREAM(e.what());
+    return;
+  }
+
+  // read parameters
+  ros::NodeHandle nh_priv("~");
+  double rate;
+  if (nh_priv.getParam("publish_rate", rate))
+    publish_rate_ = ros::Rate(rate);
+
+  XmlRpc::XmlRpcValue patterns;
+  if (nh_priv.getParam("patterns", patterns))
+  {
+    if (patterns.getType() == XmlRpc::XmlRpcValue::TypeArray)
+    {
+      patterns_ = 0;
+      for (int32_t index = 0; index < patterns.size(); ++index)
+      {
+        if (patterns[index].getType() != XmlRpc::XmlRpcValue::TypeString) continue;
+        const std::string name = static_cast<std::string>(patterns[index]);
+        if (name == "blobs") patterns_ |= BLOBS;
+        else if (name == "noise") patterns_ |= NOISE;
+        else if (name == "impacts") patterns_ |= IMPACTS;
+        else ROS_WARN("unknown activity pattern: %s", name.c_str());
+      }
+    }
+    else
+    {
+      ROS_ERROR("patterns is not an array but type %d", patterns.getType());
+    }
+  }
+
+  nh_priv.param("amplitude", amplitude_, amplitude_);
+  nh_priv.param("sparsity", sparsity_, sparsity_);
+  nh_priv.param("noise_amplitude", noise_amplitude_, noise_amplitude_);
+  nh_priv.param("blob_sigma", blob_sigma_, blob_sigma_);
+  nh_priv.param("blob_speed", blob_speed_, blob_speed_);
+  nh_priv.param("impact_rate", impact_rate_, impact_rate_);
+  nh_priv.param("impact_radius", impact_radius_, impact_radius_);
+  nh_priv.param("impact_duration", impact_duration_, impact_duration_);
+  sparsity_ = std::min(std::max(sparsity_, 0.0f), 1.0f);
+
+  int seed, num_blobs = 3;
+  if (nh_priv.getParam("seed", seed) && seed != 0)
+    rng_state_ = seed;
+  nh_priv.param("blobs", num_blobs, num_blobs);
+
+  // blobs start at random positions, moving into random directions
+  blobs_.resize(std::max(num_blobs, 0));
+  for (Blob &b : blobs_)
+  {
+    float angle = 2.0 * M_PI * uniform();
+    b.x = uniform(); b.y = uniform();
+    b.vx = blob_speed_ * std::cos(angle);
+    b.vy = blob_speed_ * std::sin(angle);
+  }
+}
+
+void LoadGenerator::createChannels(const urdf::SensorMap &sensors)
+{
+  std::map<std::string, size_t> channel_map;
+  // raw (link-frame) positions per channel, normalized when all sensors are known
+  std::vector<std::vector<std::pair<urdf::Vector3, unsigned int> > > positions;
+
+  // loop over all the sensor found in the URDF
+  for (auto it = sensors.begin(); it != sensors.end(); ++it)
+  {
+    TactileSensorSharedPtr sensor = tactile_sensor_cast(it->second);
+    if (!sensor) continue;  // some other sensor than tactile
+
+    auto res = channel_map.insert(std::make_pair(sensor->channel_, channels_.size()));
+    if (res.second)
+    {
+      sensor_msgs::ChannelFloat32 data;
+      data.name = sensor->channel_;
+      tactile_msg_.sensors.push_back(data);
+      channels_.push_back(Channel());
+      channels_.back().msg_idx = tactile_msg_.sensors.size() - 1;
+      positions.resize(channels_.size());
+    }
+    const size_t c = res.first->second;
+
+    size_t size = tactile_msg_.sensors[channels_[c].msg_idx].values.size();
+    for (auto taxel = TaxelInfoIterator::begin(it->second),
+         end = TaxelInfoIterator::end(it->second); taxel != end; ++taxel)
+    {
+      positions[c].push_back(std::make_pair(taxel->position, taxel->idx));
+      size = std::max(size, taxel->idx + 1);
+    }
+    tactile_msg_.sensors[channels_[c].msg_idx].values.resize(size, 0.0f);
+  }
+
+  for (size_t c = 0; c < channels_.size(); ++c)
+  {
+    std::vector<std::pair<urdf::Vector3, unsigned int> > &p = positions[c];
+    if (p.empty()) continue;
+
+    // bounding box of channel
+    double lo[2] = {p[0].first.x, p[0].first.y};
+    double hi[2] = {lo[0], lo[1]};
+    for (const auto &t : p)
+    {
+      lo[0] = std::min(lo[0], t.first.x); hi[0] = std::max(hi[0], t.first.x);
+      lo[1] = std::min(lo[1], t.first.y); hi[1] = std::max(hi[1], t.first.y);
+    }
+    // map into unit square, degenerate axes onto its center
+    double scale[2];
+    for (int i = 0; i < 2; ++i)
+      scale[i] = hi[i] > lo[i] ? 1.0 / (hi[i] - lo[i]) : 0.0;
+
+    std::sort(p.begin(), p.end(),
+              [](const std::pair<urdf::Vector3, unsigned int> &a,
+                 const std::pair<urdf::Vector3, unsigned int> &b) { return a.first.x < b.first.x; });
+
+    Channel &channel = channels_[c];
+    channel.x.reserve(p.size());
+    channel.y.reserve(p.size());
+    channel.idx.reserve(p.size());
+    channel.active.reserve(tactile_msg_.sensors[channel.msg_idx].values.size());
+    channel.is_active.assign(tactile_msg_.sensors[channel.msg_idx].values.size(), false);
+    for (const auto &t : p)
+    {
+      channel.x.push_back(scale[0] > 0 ? (t.first.x - lo[0]) * scale[0] : 0.5f);
+      channel.y.push_back(scale[1] > 0 ? (t.first.y - lo[1]) * scale[1] : 0.5f);
+      channel.idx.push_back(t.second);
+    }
+  }
+}
+
+uint64_t LoadGenerator::random()
+{
+  uint64_t x = rng_state_;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return rng_state_ = x;
+}
+
+void LoadGenerator::add(Channel &channel, unsigned int idx, float value)
+{
+  if (!channel.is_active[idx])
+  {
+    channel.is_active[idx] = true;
+    channel.active.push_back(idx);
+  }
+  tactile_msg_.sensors[channel.msg_idx].values[idx] += value;
+}
+
+void LoadGenerator::splat(Channel &channel, float x, float y, float radius, float sigma, float value)
+{
+  // taxels are sorted by x: restrict search to the slab [x-radius, x+radius]
+  auto begin = std::lower_bound(channel.x.begin(), channel.x.end(), x - radius);
+  auto end = std::upper_bound(begin, channel.x.end(), x + radius);
+  const float r2 = radius * radius;
+  const float s = sigma > 0 ? -0.5f / (sigma * sigma) : 0.0f;
+  for (size_t i = begin - channel.x.begin(), e = end - channel.x.begin(); i != e; ++i)
+  {
+    const float dx = channel.x[i] - x;
+    const float dy = channel.y[i] - y;
+    const float d2 = dx*dx + dy*dy;
+    if (d2 > r2) continue;
+    add(channel, channel.idx[i], s != 0.0f ? value * std::exp(s * d2) : value);
+  }
+}
+
+void LoadGenerator::update(double dt)
+{
+  // reset values of last cycle: only touch previously active taxels
+  for (Channel &channel : channels_)
+  {
+    std::vector<float> &values = tactile_msg_.sensors[channel.msg_idx].values;
+    for (unsigned int idx : channel.active)
+    {
+      values[idx] = 0.0f;
+      channel.is_active[idx] = false;
+    }
+    channel.active.clear();
+  }
+
+  if (patterns_ & BLOBS)
+  {
+    for (Blob &b : blobs_)
+    {
+      // move, bouncing off the borders of the unit square
+      b.x += b.vx * dt;
+      b.y += b.vy * dt;
+      if (b.x < 0.0f) { b.x = -b.x; b.vx = -b.vx; }
+      else if (b.x > 1.0f) { b.x = 2.0f - b.x; b.vx = -b.vx; }
+      if (b.y < 0.0f) { b.y = -b.y; b.vy = -b.vy; }
+      else if (b.y > 1.0f) { b.y = 2.0f - b.y; b.vy = -b.vy; }
+
+      for (Channel &channel : channels_)
+        splat(channel, b.x, b.y, 3.0f * blob_sigma_, blob_sigma_, amplitude_);
+    }
+  }
+
+  if ((patterns_ & IMPACTS) && !channels_.empty())
+  {
+    // spawn new impacts as a Poisson process
+    if (uniform() < impact_rate_ * dt)
+    {
+      Impact impact;
+      impact.channel = random() % channels_.size();
+      impact.x = uniform();
+      impact.y = uniform();
+      impact.remaining = impact_duration_;
+      impacts_.push_back(impact);
+    }
+    for (auto it = impacts_.begin(); it != impacts_.end();)
+    {
+      splat(channels_[it->channel], it->x, it->y, impact_radius_, 0.0f, amplitude_);
+      if ((it->remaining -= dt) <= 0) it = impacts_.erase(it);
+      else ++it;
+    }
+  }
+
+  if (patterns_ & NOISE)
+  {
+    for (Channel &channel : channels_)
+    {
+      const size_t n = channel.idx.size();
+      if (n == 0) continue;
+      for (size_t k = 0, count = sparsity_ * n + 0.5f; k < count; ++k)
+        add(channel, channel.idx[random() % n], noise_amplitude_ * uniform());
+    }
+  }
+}
+
+bool LoadGenerator::publish()
+{
+  // stamp and sequence number allow downstream nodes to measure latency and drops
+  tactile_msg_.header.stamp = ros::Time::now();
+  tactile_msg_.header.seq++;
+  tactile_pub_.publish(tactile_msg_);
+  if (!publish_rate_.sleep())
+  {
+    ++missed_;
+    ROS_WARN_THROTTLE(1.0, "cannot keep up with publish rate: missed %zu cycles", missed_);
+    return false;
+  }
+  return true;
+}
+
+bool LoadGenerator::valid() const
+{
+  return !channels_.empty() && patterns_ != 0;
+}
+
+
+int main(int argc, char **argv)
+{
+  ros::init(argc, argv, "tactile_load_generator");
+
+  try {
+    LoadGenerator generator;
+    if (!generator.valid()) return EINVAL;
+
+    const double dt = generator.period();
+    while (ros::ok())
+    {
+      generator.update(dt);
+      generator.publish();
+      ros::spinOnce();
+    }
+  } catch (const std::exception &e) {
+    ROS_ERROR_STREAM(e.what());
+    return EFAULT;
+  }
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <ros/ros.h>
+
+#include <tactile_msgs/TactileState.h>
+#include <urdf_parser/sensor_parser.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#define DEFAULT_PUBLISH_RATE  1000.0
+
+
+/** Publish synthetic TactileState messages for all tactile sensors of robot_description.
+ *
+ *  Taxel positions are precomputed once per channel, normalized to the unit square
+ *  and sorted along x, such that every activity pattern only touches the taxels it
+ *  actually activates: per cycle, the cost is proportional to the number of active
+ *  taxels, not to the total number of taxels.
+ */
+class LoadGenerator
+{
+public:
+  enum Pattern {BLOBS = 1, NOISE = 2, IMPACTS = 4};
+
+  LoadGenerator();
+
+  /// compute the next cycle of tactile values, advancing time by dt
+  void update(double dt);
+  /// publish the current tactile values and sleep until the next cycle
+  bool publish();
+
+  bool valid() const;
+  double period() const { return publish_rate_.expectedCycleTime().toSec(); }
+
+private:
+  /// precomputed taxel layout of a single channel
+  struct Channel
+  {
+    size_t msg_idx;                  //! index into tactile_msg_.sensors
+    std::vector<float> x, y;         //! normalized positions, sorted by x
+    std::vector<unsigned int> idx;   //! value index of each position
+    std::vector<unsigned int> active; //! value indices set in last cycle
+    std::vector<bool> is_active;     //! membership of value indices in active
+  };
+  /// moving Gaussian blob, position and velocity in normalized coordinates
+  struct Blob
+  {
+    float x, y, vx, vy;
+  };
+  /// step impact held constant for some time
+  struct Impact
+  {
+    size_t channel;
+    float x, y;
+    double remaining;
+  };
+
+  void config();
+  void createChannels(const urdf::SensorMap &sensors);
+
+  /// add value to all taxels of channel within radius around (x,y), weighted with a Gaussian of given sigma
+  void splat(Channel &channel, float x, float y, float radius, float sigma, float value);
+  /// add to taxel value, remembering it as active (once per cycle)
+  inline void add(Channel &channel, unsigned int idx, float value);
+
+  /// xorshift random number generator
+  inline uint64_t random();
+  inline float uniform() { return (random() >> 40) * (1.0f / (1 << 24)); }
+
+  ros::NodeHandle nh_;
+  ros::Publisher tactile_pub_; //! publisher
+  ros::Rate publish_rate_; //! publishing rate
+
+  /// unique output msg, reused for every cycle
+  tactile_msgs::TactileState tactile_msg_;
+  std::vector<Channel> channels_;
+
+  unsigned int patterns_; //! enabled activity patterns (bitmask of Pattern)
+  float amplitude_;       //! peak value of blobs and impacts
+  float sparsity_;        //! fraction of taxels hit by noise per cycle
+  float noise_amplitude_; //! max value of noise
+  float blob_sigma_;      //! blob standard deviation (normalized)
+  float blob_speed_;      //! blob speed (normalized units per second)
+  float impact_rate_;     //! expected number of impacts per second
+  float impact_radius_;   //! radius of impact (normalized)
+  double impact_duration_; //! duration of an impact (seconds)
+
+  std::vector<Blob> blobs_;
+  std::vector<Impact> impacts_;
+  uint64_t rng_state_;
+
+  size_t missed_; //! number of missed cycles
+};
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* End-to-end throughput probe for the tactile pipeline.
+ *
+ * Subscribes to the output of every pipeline stage and measures, within a
+ * fixed window after a warmup phase, message rate, taxel throughput, drop rate
+ * (from gaps in header.seq) and latency percentiles (from header.stamp of the
+ * synthetic source). Stages that restamp their output (tactile_state_publisher,
+ * tactile_pcl_node) only report rates. CPU load of each node is sampled from
+ * /proc at the window boundaries. The result is written as JSON to ~report.
+ */
+
+#include <ros/ros.h>
+#include <ros/master.h>
+#include <ros/network.h>
+#include <xmlrpcpp/XmlRpcClient.h>
+#include <tactile_msgs/TactileState.h>
+#include <tactile_msgs/TactileContacts.h>
+#include <sensor_msgs/PointCloud2.h>
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+struct Stage
+{
+  Stage(const std::string &name, bool sequenced)
+    : name(name), sequenced(sequenced), received(0), values(0), first_seq(0), last_seq(0) {}
+
+  std::string name;
+  bool sequenced;   //! does header carry seq and stamp of the source?
+  size_t received;  //! messages received within window
+  size_t values;    //! taxel values (or contacts, points) received within window
+  uint32_t first_seq, last_seq;
+  std::vector<double> latencies; //! seconds from source stamp to reception
+
+  /// number of messages published within window according to header.seq (0 if unknown)
+  size_t expected() const { return sequenced && received ? last_seq - first_seq + 1 : 0; }
+
+  void count(uint32_t seq)
+  {
+    if (received++ == 0) first_seq = seq;
+    last_seq = seq;
+  }
+};
+
+class Probe
+{
+public:
+  Probe(double warmup, double duration)
+    : source_("source", true), publisher_("tactile_state_publisher", false)
+    , calibrated_("tactile_state_calibrator", true), contacts_("merger", false), pcl_("tactile_pcl", false)
+  {
+    start_ = ros::WallTime::now() + ros::WallDuration(warmup);
+    end_ = start_ + ros::WallDuration(duration);
+
+    ros::TransportHints hints = ros::TransportHints().tcpNoDelay();
+    subs_.push_back(nh_.subscribe<tactile_msgs::TactileState>
+                    ("tactile", 1000, boost::bind(&Probe::onState, this, _1, boost::ref(source_)), ros::VoidPtr(), hints));
+    subs_.push_back(nh_.subscribe<tactile_msgs::TactileState>
+                    ("tactile_states", 1000, boost::bind(&Probe::onState, this, _1, boost::ref(publisher_)), ros::VoidPtr(), hints));
+    subs_.push_back(nh_.subscribe<tactile_msgs::TactileState>
+                    ("tactile_states/calibrated", 1000, boost::bind(&Probe::onState, this, _1, boost::ref(calibrated_)), ros::VoidPtr(), hints));
+    subs_.push_back(nh_.subscribe("tactile_contact_states", 1000, &Probe::onContacts, this, hints));
+    subs_.push_back(nh_.subscribe("tactile_pcl", 1000, &Probe::onCloud, this, hints));
+  }
+
+  ros::WallTime start() const { return start_; }
+  ros::WallTime end() const { return end_; }
+
+  std::vector<const Stage*> stages() const {
+    return {&source_, &publisher_, &calibrated_, &contacts_, &pcl_};
+  }
+
+private:
+  bool inWindow() const {
+    ros::WallTime now = ros::WallTime::now();
+    return now >= start_ && now < end_;
+  }
+
+  void onState(const tactile_msgs::TactileStateConstPtr &msg, Stage &stage)
+  {
+    if (!inWindow()) return;
+    const double latency = (ros::Time::now() - msg->header.stamp).toSec();
+    stage.count(msg->header.seq);
+    for (const auto &sensor : msg->sensors)
+      stage.values += sensor.values.size();
+    if (stage.sequenced) stage.latencies.push_back(latency);
+  }
+
+  void onContacts(const tactile_msgs::TactileContactsConstPtr &msg)
+  {
+    if (!inWindow()) return;
+    const ros::Time now = ros::Time::now();
+    ++contacts_.received;  // periodic output without sequence numbers
+    contacts_.values += msg->contacts.size();
+    for (const auto &contact : msg->contacts)
+      contacts_.latencies.push_back((now - contact.header.stamp).toSec());
+  }
+
+  void onCloud(const sensor_msgs::PointCloud2ConstPtr &msg)
+  {
+    if (!inWindow()) return;
+    ++pcl_.received;
+    pcl_.values += msg->width * msg->height;
+  }
+
+  ros::NodeHandle nh_;
+  std::vector<ros::Subscriber> subs_;
+  ros::WallTime start_, end_;
+  Stage source_, publisher_, calibrated_, contacts_, pcl_;
+};
+
+/// retrieve pid of a ROS node via its XML-RPC API
+static int nodePid(const std::string &node)
+{
+  XmlRpc::XmlRpcValue args, result, payload;
+  args[0] = ros::this_node::getName();
+  args[1] = node;
+  if (!ros::master::execute("lookupNode", args, result, payload, false))
+    return -1;
+
+  std::string host;
+  uint32_t port;
+  if (!ros::network::splitURI(static_cast<std::string>(payload), host, port))
+    return -1;
+
+  XmlRpc::XmlRpcClient client(host.c_str(), port, "/");
+  XmlRpc::XmlRpcValue request, response;
+  request[0] = ros::this_node::getName();
+  if (!client.execute("getPid", request, response) || response.getType() != XmlRpc::XmlRpcValue::TypeArray ||
+      response.size() != 3 || response[2].getType() != XmlRpc::XmlRpcValue::TypeInt)
+    return -1;
+  return static_cast<int>(response[2]);
+}
+
+/// CPU time (user + system) consumed by process pid in seconds, negative on failure
+static double cpuTime(int pid)
+{
+  std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+  std::string line;
+  if (pid <= 0 || !std::getline(file, line)) return -1;
+
+  // skip pid and (comm), which might contain spaces
+  std::istringstream fields(line.substr(line.rfind(')') + 2));
+  std::string field;
+  unsigned long utime = 0, stime = 0;
+  for (int i = 3; i <= 15 && fields >> field; ++i) {
+    if (i == 14) utime = std::stoul(field);
+    else if (i == 15) stime = std::stoul(field);
+  }
+  return double(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+/// nearest-rank percentile of sorted values
+static double percentile(const std::vector<double> &sorted, double p)
+{
+  if (sorted.empty()) return 0.0;
+  size_t rank = std::min(sorted.size() - 1, static_cast<size_t>(p / 100.0 * sorted.size()));
+  return sorted[rank];
+}
+
+TEST(PipelineBenchmark, throughput)
+{
+  ros::NodeHandle nh_priv("~");
+  const double warmup = nh_priv.param("warmup", 3.0);
+  const double duration = nh_priv.param("duration", 10.0);
+  const double min_rate = nh_priv.param("min_rate", 0.0);
+  const std::string report = nh_priv.param<std::string>("report", "tactile_pipeline_benchmark.json");
+  std::vector<std::string> nodes;
+  nh_priv.getParam("nodes", nodes);
+
+  Probe probe(warmup, duration);
+  ros::AsyncSpinner spinner(0);
+  spinner.start();
+
+  ros::WallTime::sleepUntil(probe.start());
+  std::vector<int> pids;
+  std::vector<double> cpu_start;
+  for (const std::string &node : nodes) {
+    pids.push_back(nodePid(node));
+    cpu_start.push_back(cpuTime(pids.back()));
+  }
+  ros::WallTime::sleepUntil(probe.end());
+  std::vector<double> cpu_end;
+  for (int pid : pids)
+    cpu_end.push_back(cpuTime(pid));
+  // wait for callbacks still processing messages of the window
+  ros::WallDuration(0.1).sleep();
+  spinner.stop();
+
+  FILE *out = fopen(report.c_str(), "w");
+  ASSERT_TRUE(out != NULL) << "cannot write report " << report;
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"duration\": %.3f,\n", duration);
+  fprintf(out, "  \"stages\": {\n");
+  const std::vector<const Stage*> stages = probe.stages();
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const Stage &s = *stages[i];
+    std::vector<double> latencies = s.latencies;
+    std::sort(latencies.begin(), latencies.end());
+    const size_t expected = s.expected();
+
+    fprintf(out, "    \"%s\": {\n", s.name.c_str());
+    fprintf(out, "      \"messages\": %zu,\n", s.received);
+    fprintf(out, "      \"rate\": %.1f,\n", s.received / duration);
+    fprintf(out, "      \"values_per_second\": %.0f", s.values / duration);
+    if (expected > 0)
+      fprintf(out, ",\n      \"drop_rate\": %.6f", 1.0 - double(s.received) / expected);
+    if (!latencies.empty()) {
+      fprintf(out, ",\n      \"latency_ms\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+              1e3 * percentile(latencies, 50), 1e3 * percentile(latencies, 90),
+              1e3 * percentile(latencies, 99), 1e3 * latencies.back());
+    }
+    fprintf(out, "\n    }%s\n", i + 1 < stages.size() ? "," : "");
+  }
+  fprintf(out, "  },\n");
+  fprintf(out, "  \"cpu_percent\": {");
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const double cpu = cpu_start[i] >= 0 && cpu_end[i] >= 0 ? 100.0 * (cpu_end[i] - cpu_start[i]) / duration : -1;
+    fprintf(out, "%s\n    \"%s\": %.1f", i ? "," : "", nodes[i].c_str(), cpu);
+  }
+  fprintf(out, "\n  }\n}\n");
+  fclose(out);
+  ROS_INFO_STREAM("pipeline benchmark report written to " << report);
+
+  // sanity checks only: actual performance numbers are tracked via the report
+  for (const Stage *s : stages) {
+    EXPECT_GT(s->received, 0u) << "no messages received from " << s->name;
+  }
+  EXPECT_GE(stages[0]->received / duration, min_rate);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "tactile_pipeline_probe");
+  ros::NodeHandle nh;  // keep node alive until the test finished
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include <tactile_control/tactile_sensor_interface.h>
+#include <tactile_control/tactile_contact_interface.h>
+#include <controller_interface/multi_interface_controller.h>
+#include <realtime_tools/realtime_publisher.h>
+#include <tactile_merger/merger.h>
+#include <tactile_msgs/TactileContacts.h>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace tactile_control {
+
+/** Estimate contacts from tactile channels within the control loop.
+ *
+ *  Channel values are read in place from the TactileSensorInterface and routed
+ *  directly into the merger core. Results are written to the handles of the
+ *  (optional) TactileContactInterface, which other controllers can read in the
+ *  same cycle, and may be published at ~publish_rate for monitoring.
+ */
+class ContactEstimationController
+   : public controller_interface::MultiInterfaceController<TactileSensorInterface, TactileContactInterface>
+{
+public:
+	ContactEstimationController();
+
+	bool init(hardware_interface::RobotHW *hw, ros::NodeHandle &root_nh, ros::NodeHandle &nh) override;
+	void starting(const ros::Time &time) override;
+	void update(const ros::Time &time, const ros::Duration &period) override;
+
+private:
+	tactile::Merger merger_;
+	/// sensor handles and their core channel
+	std::vector<std::pair<TactileSensorHandle, tactile::MergerCore::index_t> > channels_;
+	/// contact handle for each group of the core (NULL if not provided by the hardware)
+	std::vector<boost::shared_ptr<TactileContactHandle> > contacts_;
+
+	boost::scoped_ptr<realtime_tools::RealtimePublisher<tactile_msgs::TactileContacts> > pub_;
+	/// preallocated contact msg per group, name and frame_id being filled once in init()
+	std::vector<tactile_msgs::TactileContact> contact_msgs_;
+	/// group of each entry in pub_->msg_.contacts, to swap it back into contact_msgs_
+	std::vector<tactile::MergerCore::index_t> published_;
+	ros::Duration publish_period_;
+	ros::Time last_publish_;
+};
+
+} // namespace tactile_control
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include <hardware_interface/internal/hardware_resource_manager.h>
+#include <Eigen/Core>
+#include <string>
+
+namespace tactile_control {
+
+/// contact estimate of a link, expressed w.r.t. the link frame
+struct TactileContact
+{
+	TactileContact() : valid(false), stamp(0),
+	   position(Eigen::Vector3d::Zero()), normal(Eigen::Vector3d::Zero()),
+	   force(Eigen::Vector3d::Zero()), torque(Eigen::Vector3d::Zero()) {}
+
+	bool valid;               /// is the link in contact?
+	double stamp;             /// time of estimation (seconds)
+	Eigen::Vector3d position; /// contact location
+	Eigen::Vector3d normal;   /// surface normal at contact
+	Eigen::Vector3d force;    /// net contact force
+	Eigen::Vector3d torque;   /// net torque w.r.t. link frame
+};
+
+/** Handle to the contact estimate of a link (named after the link).
+ *
+ *  The storage is owned by the RobotHW. A contact estimation controller writes it,
+ *  any other controller may read it within the same control cycle.
+ */
+class TactileContactHandle
+{
+public:
+	TactileContactHandle() : contact_(0) {}
+	TactileContactHandle(const std::string &name, TactileContact *contact)
+	   : name_(name), contact_(contact)
+	{
+		if (!contact_)
+			throw hardware_interface::HardwareInterfaceException("Cannot create handle '" + name + "'. Contact pointer is null.");
+	}
+
+	std::string getName() const {return name_;}
+	const TactileContact& get() const {return *contact_;}
+	void set(const TactileContact &contact) {*contact_ = contact;}
+	void invalidate() {contact_->valid = false;}
+
+private:
+	std::string name_;
+	TactileContact *contact_;
+};
+
+/// hardware interface providing contact estimates, keyed by link name
+class TactileContactInterface
+   : public hardware_interface::HardwareResourceManager<TactileContactHandle, hardware_interface::DontClaimResources>
+{};
+
+} // namespace tactile_control
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include "tactile_sensor_interface.h"
+#include "tactile_contact_interface.h"
+#include <urdf_parser/sensor_parser.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tactile_control {
+
+/** Storage for all tactile channels and contact estimates described by the URDF.
+ *
+ *  A RobotHW can use it to allocate the values and stamp of all channels (to be filled
+ *  by its driver in read()) and a contact slot for each link carrying tactile sensors,
+ *  and to register the corresponding handles with its interfaces.
+ */
+class TactileResources
+{
+public:
+	/// create channels and contact slots from the tactile sensors found in given parameter
+	void init(const std::string &param = "robot_description");
+	void init(const urdf::SensorMap &sensors);
+
+	void registerHandles(TactileSensorInterface &sensors);
+	void registerHandles(TactileContactInterface &contacts);
+
+	/// values of channel, to be filled by the driver (throws std::out_of_range for unknown channels)
+	std::vector<float>& values(const std::string &channel) {return channels_.at(channel).values;}
+	/// acquisition time (seconds) of channel's values, to be advanced by the driver
+	double& stamp(const std::string &channel) {return channels_.at(channel).stamp;}
+	/// contact estimate of link (throws std::out_of_range for unknown links)
+	const TactileContact& contact(const std::string &link) const {return contacts_.at(link);}
+
+private:
+	struct Channel {
+		Channel() : stamp(0) {}
+		std::vector<float> values;
+		double stamp;
+	};
+	std::map<std::string, Channel> channels_;
+	std::map<std::string, TactileContact> contacts_;
+};
+
+} // namespace tactile_control
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include <hardware_interface/internal/hardware_resource_manager.h>
+#include <string>
+
+namespace tactile_control {
+
+/** Read-only view onto the raw values of a tactile channel.
+ *
+ *  The values are owned by the RobotHW (or its driver) and are read in place
+ *  by controllers, without copying or serialization. The RobotHW advances the
+ *  channel's stamp in read() whenever new values arrived, such that consumers
+ *  can detect a stalled driver.
+ */
+class TactileSensorHandle
+{
+public:
+	TactileSensorHandle() : data_(0), size_(0), stamp_(0) {}
+	TactileSensorHandle(const std::string &name, const float *data, size_t size, const double *stamp)
+	   : name_(name), data_(data), size_(size), stamp_(stamp)
+	{
+		if (!data_ && size_)
+			throw hardware_interface::HardwareInterfaceException("Cannot create handle '" + name + "'. Data pointer is null.");
+		if (!stamp_)
+			throw hardware_interface::HardwareInterfaceException("Cannot create handle '" + name + "'. Stamp pointer is null.");
+	}
+
+	/// channel name as given in the URDF tactile sensor description
+	std::string getName() const {return name_;}
+	const float* data() const {return data_;}
+	size_t size() const {return size_;}
+	const float* begin() const {return data_;}
+	const float* end() const {return data_ + size_;}
+	float operator[](size_t i) const {return data_[i];}
+	/// time (seconds) at which the current values were acquired
+	double getStamp() const {return *stamp_;}
+
+private:
+	std::string name_;
+	const float *data_;
+	size_t size_;
+	const double *stamp_;
+};
+
+/// hardware interface providing read-only tactile channels, keyed by channel name
+class TactileSensorInterface
+   : public hardware_interface::HardwareResourceManager<TactileSensorHandle, hardware_interface::DontClaimResources>
+{};
+
+} // namespace tactile_control
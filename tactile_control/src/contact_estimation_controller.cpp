@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tactile_control/contact_estimation_controller.h>
+#include <pluginlib/class_list_macros.h>
+#include <algorithm>
+
+namespace tactile_control {
+
+ContactEstimationController::ContactEstimationController()
+   : controller_interface::MultiInterfaceController<TactileSensorInterface, TactileContactInterface>(true)
+{
+}
+
+bool ContactEstimationController::init(hardware_interface::RobotHW *hw,
+                                       ros::NodeHandle &root_nh, ros::NodeHandle &nh)
+{
+	// both interfaces are optional for MultiInterfaceController, but we need sensor data
+	TactileSensorInterface *sensors = hw->get<TactileSensorInterface>();
+	if (!sensors) {
+		ROS_ERROR("ContactEstimationController requires a TactileSensorInterface");
+		return false;
+	}
+
+	try {
+		merger_.init(nh.param<std::string>("robot_description", "robot_description"));
+	} catch (const std::exception &e) {
+		ROS_ERROR_STREAM("failed to initialize merger: " << e.what());
+		return false;
+	}
+	tactile::MergerCore &core = merger_.core();
+	core.setTimeout(nh.param("timeout", 1.0));
+
+	channels_.clear();
+	const std::vector<std::string> &names = sensors->getNames();
+	for (auto it = names.begin(), end = names.end(); it != end; ++it) {
+		const tactile::MergerCore::index_t ch = core.channel(*it);
+		if (ch == tactile::MergerCore::NONE) {
+			ROS_WARN_STREAM("ignoring channel " << *it << ": not described in robot_description");
+			continue;
+		}
+		channels_.push_back(std::make_pair(sensors->getHandle(*it), ch));
+	}
+	if (channels_.empty()) {
+		ROS_ERROR("no tactile channels available");
+		return false;
+	}
+
+	// contact handles are shared (DontClaimResources): other controllers may read them
+	contacts_.clear();
+	contacts_.resize(core.groups());
+	if (TactileContactInterface *contacts = hw->get<TactileContactInterface>()) {
+		const std::vector<std::string> &links = contacts->getNames();
+		for (tactile::MergerCore::index_t g = 0; g < core.groups(); ++g) {
+			const std::string &link = core.groupName(g);
+			if (std::find(links.begin(), links.end(), link) != links.end())
+				contacts_[g].reset(new TactileContactHandle(contacts->getHandle(link)));
+		}
+	}
+
+	const double rate = nh.param("publish_rate", 0.0);
+	if (rate > 0.0) {
+		publish_period_ = ros::Duration(1.0 / rate);
+		pub_.reset(new realtime_tools::RealtimePublisher<tactile_msgs::TactileContacts>
+		           (root_nh, "tactile_contact_states", 4));
+		pub_->msg_.contacts.reserve(core.groups());
+	} else
+		pub_.reset();
+
+	contact_msgs_.clear();
+	contact_msgs_.resize(pub_ ? core.groups() : 0);
+	for (size_t g = 0; g < contact_msgs_.size(); ++g) {
+		contact_msgs_[g].name = core.groupName(g);
+		contact_msgs_[g].header.frame_id = core.groupFrame(g);
+	}
+	published_.clear();
+	published_.reserve(contact_msgs_.size());
+
+	return true;
+}
+
+void ContactEstimationController::starting(const ros::Time &time)
+{
+	last_publish_ = time;
+	for (auto it = contacts_.begin(), end = contacts_.end(); it != end; ++it)
+		if (*it) (*it)->invalidate();
+}
+
+void ContactEstimationController::update(const ros::Time &time, const ros::Duration &)
+{
+	tactile::MergerCore &core = merger_.core();
+	const double now = time.toSec();
+
+	// read driver memory in place, without any intermediate copy
+	// channels keep their acquisition stamp, such that groups of a stalled driver time out
+	for (auto it = channels_.begin(), end = channels_.end(); it != end; ++it)
+		core.read(it->second, it->first.begin(), it->first.end(), it->first.getStamp());
+	const size_t n = core.compute(now);
+	const std::vector<tactile::MergerCore::Contact> &result = core.contacts();
+
+	for (auto it = contacts_.begin(), end = contacts_.end(); it != end; ++it)
+		if (*it) (*it)->invalidate();
+	for (size_t i = 0; i < n; ++i) {
+		const tactile::MergerCore::Contact &c = result[i];
+		const boost::shared_ptr<TactileContactHandle> &handle = contacts_[c.group];
+		if (!handle) continue;
+
+		TactileContact contact;
+		contact.valid = true;
+		contact.stamp = c.stamp;
+		contact.position = c.position;
+		contact.normal = c.normal;
+		contact.force = c.force;
+		contact.torque = c.torque;
+		handle->set(contact);
+	}
+
+	if (pub_ && time >= last_publish_ + publish_period_ && pub_->trylock()) {
+		last_publish_ = time;
+		// strings were filled in init(): entries are only swapped between contact_msgs_
+		// and the published msg, such that update() writes numeric fields only
+		std::vector<tactile_msgs::TactileContact> &msgs = pub_->msg_.contacts;
+		for (size_t i = 0; i < published_.size(); ++i)
+			std::swap(msgs[i], contact_msgs_[published_[i]]);
+		published_.clear();
+		msgs.resize(n); // within reserved capacity, (de)constructing empty entries only
+		for (size_t i = 0; i < n; ++i) {
+			const tactile::MergerCore::index_t g = result[i].group;
+			tactile::Merger::toMsg(result[i], contact_msgs_[g]);
+			std::swap(msgs[i], contact_msgs_[g]);
+			published_.push_back(g);
+		}
+		pub_->unlockAndPublish();
+	}
+}
+
+} // namespace tactile_control
+
+PLUGINLIB_EXPORT_CLASS(tactile_control::ContactEstimationController, controller_interface::ControllerBase)
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <tactile_control/tactile_resources.h>
+#include <urdf/sensor.h>
+#include <urdf_tactile/tactile.h>
+#include <urdf_tactile/cast.h>
+#include <algorithm>
+
+using namespace urdf::tactile;
+
+namespace tactile_control {
+
+void TactileResources::init(const std::string &param)
+{
+	init(urdf::parseSensorsFromParam(param, urdf::getSensorParser("tactile")));
+}
+
+void TactileResources::init(const urdf::SensorMap &sensors)
+{
+	channels_.clear();
+	contacts_.clear();
+
+	for (auto it = sensors.begin(); it != sensors.end(); ++it) {
+		TactileSensorSharedPtr sensor = tactile_sensor_cast(it->second);
+		if (!sensor) continue;  // some other sensor than tactile
+
+		size_t size = 0;
+		if (sensor->array_)
+			size = sensor->array_->rows * sensor->array_->cols;
+		for (auto taxel = sensor->taxels_.begin(), end = sensor->taxels_.end(); taxel != end; ++taxel)
+			size = std::max<size_t>(size, (*taxel)->idx + 1);
+
+		// several sensors might share a channel
+		std::vector<float> &values = channels_[sensor->channel_].values;
+		if (values.size() < size)
+			values.resize(size, 0.0f);
+
+		// contacts are estimated per link
+		contacts_[it->second->parent_link_];
+	}
+}
+
+void TactileResources::registerHandles(TactileSensorInterface &sensors)
+{
+	for (auto it = channels_.begin(), end = channels_.end(); it != end; ++it)
+		sensors.registerHandle(TactileSensorHandle(it->first, it->second.values.data(), it->second.values.size(),
+		                                           &it->second.stamp));
+}
+
+void TactileResources::registerHandles(TactileContactInterface &contacts)
+{
+	for (auto it = contacts_.begin(), end = contacts_.end(); it != end; ++it)
+		contacts.registerHandle(TactileContactHandle(it->first, &it->second));
+}
+
+} // namespace tactile_control
@@ -28,28 +28,54 @@
  */
 #pragma once
 #include "taxel_group.h"
+#include "merger_core.h"
 #include <ros/time.h>
 #include <tactile_msgs/TactileContacts.h>
+#include <tactile_msgs/TactileState.h>
 
 namespace tactile {
 
+/** ROS interface to MergerCore, loading the taxel layout from robot_description.
+ *
+ *  update() and getContacts() may run in different threads, but each of them
+ *  only from a single thread (see MergerCore).
+ */
 class Merger
 {
 public:
+	/** Cached channel lookup for the sensor layout of one input topic.
+	 *  Entry i holds the core channel of msg.sensors[i]. It is only rebuilt when
+	 *  the channel name at that position changes (or after re-init of the merger).
+	 */
+	class DispatchTable {
+		friend class Merger;
+		size_t generation_ = 0;
+		std::vector<std::string> names_;
+		std::vector<MergerCore::index_t> channels_;
+	};
+
 	Merger();
 	void init(const std::string &param="robot_description");
 
 	template <typename Iterator>
 	void update(const ros::Time &stamp, const std::string &channel,
 	            Iterator begin, Iterator end);
+	/// update all channels of msg, using (and maintaining) the dispatch table of its topic
+	void update(const tactile_msgs::TactileState &msg, DispatchTable &table);
 	tactile_msgs::TactileContacts getContacts();
+	/// convert the first n contacts computed by the core into msg
+	void toMsg(size_t n, tactile_msgs::TactileContacts &msg) const;
+	/// fill only the numeric fields (stamp, position, normal, wrench) of msg from c
+	static void toMsg(const MergerCore::Contact &c, tactile_msgs::TactileContact &msg);
 
-private:
-	struct GroupData;
-	typedef boost::shared_ptr<GroupData> GroupDataPtr;
+	/// ROS-free core, e.g. to be used directly within a control loop
+	MergerCore& core() {return core_;}
+	const MergerCore& core() const {return core_;}
 
-	std::map<std::string, GroupDataPtr> groups_;
-	std::multimap<std::string, std::pair<GroupDataPtr, const TaxelGroup::TaxelMapping*> > sensors_;
+private:
+	MergerCore core_;
+	/// incremented on init() to invalidate all dispatch tables
+	size_t generation_;
 };
 
 } // namespace tactile
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include "taxel_grid.h"
+#include "triple_buffer.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tactile {
+
+/** ROS-free, real-time safe core of the Merger.
+ *
+ *  All buffers are allocated during setup (addGroup(), addTaxel(), addGrid(), addChannel(),
+ *  mapTaxel(), mapGrid(), finalize()). Afterwards, write() and compute() neither allocate nor lock:
+ *  Each channel passes its values through a lock-free triple buffer, which allows a single
+ *  producer per channel and a single consumer calling compute(), e.g. from a control loop.
+ *  Time stamps are passed explicitly (in seconds) and are never read from a clock.
+ */
+class MergerCore
+{
+public:
+	typedef size_t index_t;
+	static const index_t NONE = std::numeric_limits<index_t>::max();
+
+	/// contact estimate of a group, expressed w.r.t. the group's (link) frame
+	struct Contact {
+		index_t group;            /// index of group
+		double stamp;             /// stamp of most recent input of this group
+		Eigen::Vector3d position; /// weighted mean of taxel positions
+		Eigen::Vector3d normal;   /// weighted mean of taxel normals
+		Eigen::Vector3d force;    /// force acting opposite to normal
+		Eigen::Vector3d torque;   /// torque w.r.t. frame origin
+	};
+
+	MergerCore();
+
+	// setup: not real-time safe
+	void clear();
+	/// add a group of taxels attached to a common frame
+	index_t addGroup(const std::string &name, const std::string &frame);
+	/// add a taxel to a group, returning its index within the group
+	index_t addTaxel(index_t group, const Eigen::Vector3d &position, const Eigen::Vector3d &normal);
+	/// add a taxel grid to a group, returning its index within the group
+	index_t addGrid(index_t group, const TaxelGrid &grid);
+	/// add an input channel (or return the existing one of that name)
+	index_t addChannel(const std::string &name);
+	/// route value idx of channel onto a taxel of group
+	void mapTaxel(index_t channel, size_t idx, index_t group, index_t taxel);
+	/// route all values of channel onto a grid of group
+	void mapGrid(index_t channel, index_t group, index_t grid);
+	/// allocate input buffers and results, needs to be called after setup
+	void finalize();
+
+	/// ignore groups without input for longer than timeout seconds
+	void setTimeout(double timeout) {timeout_ = timeout;}
+
+	size_t groups() const {return groups_.size();}
+	const std::string& groupName(index_t group) const {return groups_[group].name;}
+	const std::string& groupFrame(index_t group) const {return groups_[group].frame;}
+	size_t channels() const {return channels_.size();}
+	const std::string& channelName(index_t channel) const {return channels_[channel]->name;}
+	/// lookup channel index by name (not real-time safe), returns NONE if unknown
+	index_t channel(const std::string &name) const;
+
+	// producer side: real-time safe, single producer per channel
+	/// pass new values of a channel (excess values are ignored, missing ones are zeroed)
+	template <typename Iterator>
+	void write(index_t channel, Iterator begin, Iterator end, double stamp);
+
+	// consumer side: real-time safe, single consumer
+	/// route values of a channel directly onto taxels and grids, bypassing its input buffer
+	/// (for use within the consumer's loop, e.g. reading driver memory in a controller)
+	template <typename Iterator>
+	void read(index_t channel, Iterator begin, Iterator end, double stamp) {
+		route(*channels_[channel], begin, end, stamp);
+	}
+	/// fetch latest inputs and compute contacts of all groups in contact, returning their number
+	size_t compute(double now);
+	/// contacts computed by last compute(): only the first n entries are valid
+	const std::vector<Contact>& contacts() const {return contacts_;}
+
+private:
+	struct Group {
+		std::string name;
+		std::string frame;
+		std::vector<Eigen::Vector3d> positions;
+		std::vector<Eigen::Vector3d> normals;
+		std::vector<double> weights;
+		std::vector<TaxelGrid> grids;
+		double stamp;
+	};
+	/// input values with their time stamp
+	struct Frame {
+		std::vector<float> values;
+		double stamp;
+	};
+	/// route of a channel value onto a taxel
+	struct TaxelRoute {
+		size_t idx;
+		index_t group, taxel;
+	};
+	/// route of a channel onto a grid
+	struct GridRoute {
+		index_t group, grid;
+	};
+	struct Channel {
+		std::string name;
+		size_t size;  /// number of values
+		std::vector<TaxelRoute> taxels;
+		std::vector<GridRoute> grids;
+		TripleBuffer<Frame> buffer;
+	};
+
+	template <typename Iterator>
+	void route(const Channel &ch, Iterator begin, Iterator end, double stamp);
+
+	std::vector<Group> groups_;
+	std::vector<std::unique_ptr<Channel> > channels_;
+	std::vector<Contact> contacts_;
+	double timeout_;
+};
+
+template <typename Iterator>
+void MergerCore::write(index_t channel, Iterator begin, Iterator end, double stamp)
+{
+	Channel &ch = *channels_[channel];
+	Frame &frame = ch.buffer.writeBuffer();
+	const size_t n = std::min<size_t>(end - begin, ch.size);
+	std::copy(begin, begin + n, frame.values.begin());
+	std::fill(frame.values.begin() + n, frame.values.end(), 0.0f);
+	frame.stamp = stamp;
+	ch.buffer.publish();
+}
+
+template <typename Iterator>
+void MergerCore::route(const Channel &ch, Iterator begin, Iterator end, double stamp)
+{
+	const size_t n = end - begin;
+	for (auto r = ch.taxels.begin(), rend = ch.taxels.end(); r != rend; ++r) {
+		Group &g = groups_[r->group];
+		g.weights[r->taxel] = r->idx < n ? *(begin + r->idx) : 0.0;
+		g.stamp = stamp;
+	}
+	for (auto r = ch.grids.begin(), rend = ch.grids.end(); r != rend; ++r) {
+		Group &g = groups_[r->group];
+		g.grids[r->grid].update(begin, end);
+		g.stamp = stamp;
+	}
+}
+
+} // namespace tactile
@@ -38,7 +38,6 @@ struct Taxel
 
 	Eigen::Vector3d position;
 	Eigen::Vector3d normal;
-	double weight;
 };
 
 } // namespace tactile
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include <Eigen/Core>
+#include <cstddef>
+
+namespace tactile {
+
+/** Regular, coplanar grid of taxels of a TactileArray sensor.
+ *  Instead of expanding the grid into individual taxels, its zeroth and first
+ *  moments are accumulated directly from the channel values. The centroid in
+ *  grid coordinates is mapped into the link frame only once when averaging.
+ */
+struct TaxelGrid
+{
+	unsigned int rows, cols;
+	bool row_major;
+	Eigen::Vector3d base;     /// center of cell (0,0) w.r.t. link frame
+	Eigen::Vector3d row_step; /// offset between adjacent rows w.r.t. link frame
+	Eigen::Vector3d col_step; /// offset between adjacent columns w.r.t. link frame
+	Eigen::Vector3d normal;   /// common normal of all cells
+
+	double m0;   /// zeroth moment: sum of all values
+	double mr;   /// first moment: sum of values * row
+	double mc;   /// first moment: sum of values * col
+
+	size_t size() const {return size_t(rows) * cols;}
+
+	/// update moments from row- or column-major values
+	/// returns false and zeros all moments if there are too few values
+	template <typename Iterator>
+	bool update(Iterator begin, Iterator end);
+
+	/// weighted sum of cell centers: sum_ij v_ij * (base + i*row_step + j*col_step)
+	Eigen::Vector3d weightedPosition() const {
+		return m0 * base + mr * row_step + mc * col_step;
+	}
+};
+
+template <typename Iterator>
+bool TaxelGrid::update(Iterator begin, Iterator end)
+{
+	// outer/inner loop over contiguous memory layout
+	const size_t outer = row_major ? rows : cols;
+	const size_t inner = row_major ? cols : rows;
+	if (end - begin < static_cast<std::ptrdiff_t>(outer * inner)) {
+		m0 = mr = mc = 0.0;  // don't keep stale moments
+		return false;
+	}
+
+	// separable sums: m_outer = sum_o o * sum_i v, m_inner = sum_o sum_i i * v
+	double sum0 = 0, mo = 0, mi = 0;
+	Iterator it = begin;
+	for (size_t o = 0; o < outer; ++o) {
+		double sum = 0, isum = 0;
+		for (size_t i = 0; i < inner; ++i, ++it) {
+			const double v = *it;
+			sum += v;
+			isum += i * v;
+		}
+		sum0 += sum;
+		mo += o * sum;
+		mi += isum;
+	}
+	m0 = sum0;
+	mr = row_major ? mo : mi;
+	mc = row_major ? mi : mo;
+	return true;
+}
+
+} // namespace tactile
@@ -28,8 +28,8 @@
  */
 #pragma once
 #include "taxel.h"
+#include "taxel_grid.h"
 #include <urdf_tactile/tactile.h>
-#include <tactile_msgs/TactileContact.h>
 #include <map>
 #include <vector>
 
@@ -50,6 +50,11 @@ public:
 	typedef std::map<index_t, index_t> TaxelMapping;
 	/// mapping from a channel name onto its TaxelMapping
 	typedef std::map<std::string, TaxelMapping> SensorToTaxelMapping;
+	/// mapping from a channel name onto an index into arrays_
+	typedef std::map<std::string, index_t> SensorToArrayMapping;
+
+	/// regular taxel grid of a TactileArray sensor
+	typedef TaxelGrid Array;
 
 	/// load TaxelGroups from robot_description, identified by group name
 	static TaxelGroupMap load(const std::string &desc_param);
@@ -61,10 +66,8 @@ public:
 	const std::vector<Taxel>& taxels() const {return taxels_;}
 	size_t size() const {return taxels_.size();}
 	const SensorToTaxelMapping& mappings() const {return mappings_;}
-
-	template <typename Iterator>
-	void update(const TaxelMapping &mapping, Iterator begin, Iterator end);
-	bool average(tactile_msgs::TactileContact &contact);
+	const std::vector<Array>& arrays() const {return arrays_;}
+	const SensorToArrayMapping& arrayMappings() const {return array_mappings_;}
 
 private:
 	void addTaxel(const Taxel &taxel);
@@ -76,6 +79,10 @@ private:
 	std::vector<Taxel> taxels_;
 	/// mapping from channel name onto its TaxelMapping
 	SensorToTaxelMapping mappings_;
+	/// taxel arrays within this group
+	std::vector<Array> arrays_;
+	/// mapping from channel name onto its array
+	SensorToArrayMapping array_mappings_;
 };
 
 } // namespace tactile
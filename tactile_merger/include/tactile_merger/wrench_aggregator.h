@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include <tactile_msgs/TactileContacts.h>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tf2_ros { class Buffer; }
+
+namespace tactile {
+
+/** Aggregate the contacts of several links into a single net wrench w.r.t. a common frame.
+ *
+ *  Each link set (e.g. "left_hand") sums the wrenches of all contacts reported for its links.
+ *  Link poses are looked up once per cycle via refresh() and cached, such that aggregate()
+ *  only needs to apply precomputed transforms. If a lookup fails, the previous pose is kept.
+ */
+class WrenchAggregator
+{
+public:
+	/// add a link set with given name, summing the contacts of links w.r.t. frame
+	void addSet(const std::string &name, const std::string &frame, const std::vector<std::string> &links);
+	/// load link sets from an XmlRpc struct: {name: {frame: ..., links: [...]}, ...}
+	void load(const std::string &param);
+	bool empty() const {return sets_.empty();}
+
+	/// refresh cached link poses from tf, returns false if any lookup failed
+	bool refresh(const tf2_ros::Buffer &tf);
+	/// set cached pose of a link of set s (w.r.t. the set's frame)
+	void setTransform(size_t s, const std::string &link, const Eigen::Isometry3d &pose);
+
+	/// compute net wrench of each set from given contacts, one contact per set
+	void aggregate(const tactile_msgs::TactileContacts &contacts, tactile_msgs::TactileContacts &result) const;
+
+private:
+	struct Set {
+		std::string name;
+		std::string frame;
+		std::vector<std::string> links;
+		std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d> > poses; /// cached link poses w.r.t. frame
+		std::vector<bool> valid;              /// validity of cached poses
+	};
+	std::vector<Set> sets_;
+	/// mapping from link name onto (set index, link index) pairs
+	std::multimap<std::string, std::pair<size_t, size_t> > links_;
+};
+
+} // namespace tactile
@@ -28,96 +28,119 @@
  */
 #include "merger.h"
 #include <tactile_msgs/TactileContacts.h>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/locks.hpp>
 #include <ros/console.h>
-#include <deque>
 
 namespace tactile {
 
-struct Merger::GroupData {
-	GroupData(const TaxelGroupPtr &group);
-
-	mutable boost::mutex mutex;
-	TaxelGroupPtr group;
-	ros::Time timestamp;
-};
-
-Merger::GroupData::GroupData(const TaxelGroupPtr &group)
-   : group(group)
-{
-}
-
-
 Merger::Merger()
+   : generation_(0)
 {
 }
 
 void Merger::init(const std::string &param)
 {
-	sensors_.clear();
-	groups_.clear();
+	core_.clear();
+	++generation_;
 
 	const TaxelGroupMap &groups = TaxelGroup::load(param);
 	for (auto it = groups.begin(), end = groups.end(); it != end; ++it) {
-		TaxelGroupPtr group = it->second;
-		GroupDataPtr data(new GroupData(group));
-		groups_.insert(std::make_pair(it->first, data));
+		const TaxelGroupPtr &group = it->second;
+		const MergerCore::index_t g = core_.addGroup(it->first, group->frame());
+
+		const std::vector<Taxel> &taxels = group->taxels();
+		for (auto t = taxels.begin(), tend = taxels.end(); t != tend; ++t)
+			core_.addTaxel(g, t->position, t->normal);
+		const std::vector<TaxelGroup::Array> &arrays = group->arrays();
+		for (auto a = arrays.begin(), aend = arrays.end(); a != aend; ++a)
+			core_.addGrid(g, *a);
+
+		// route channels onto taxels and arrays
 		const TaxelGroup::SensorToTaxelMapping& m = group->mappings();
 		for (auto sit = m.begin(), send = m.end(); sit != send; ++sit) {
-			// create mapping from channel name to (data, m)
-			auto pair = std::make_pair(data, &sit->second);
-			sensors_.insert(std::make_pair(sit->first, pair));
+			const MergerCore::index_t ch = core_.addChannel(sit->first);
+			for (auto t = sit->second.begin(), tend = sit->second.end(); t != tend; ++t)
+				core_.mapTaxel(ch, t->first, g, t->second);
 		}
+		const TaxelGroup::SensorToArrayMapping& a = group->arrayMappings();
+		for (auto ait = a.begin(), aend = a.end(); ait != aend; ++ait)
+			core_.mapGrid(core_.addChannel(ait->first), g, ait->second);
 	}
+	core_.finalize();
 }
 
 template <typename Iterator>
 void Merger::update(const ros::Time &stamp, const std::string &channel,
                     Iterator begin, Iterator end) {
-	auto range = sensors_.equal_range(channel);
-	if (range.first == range.second) {
+	const MergerCore::index_t ch = core_.channel(channel);
+	if (ch == MergerCore::NONE) {
 		ROS_ERROR_STREAM_ONCE("unknown channel: " << channel);
 		return;
 	}
-
-	for (auto ch = range.first, range_end = range.second; ch != range_end; ++ch) {
-		GroupDataPtr &data = ch->second.first;
-		TaxelGroupPtr &group = data->group;
-		const TaxelGroup::TaxelMapping &mapping = *ch->second.second;
-		{
-			boost::unique_lock<boost::mutex> lock(data->mutex);
-			data->timestamp = stamp;
-			group->update(mapping, begin, end);
-		}
-	}
+	core_.write(ch, begin, end, stamp.toSec());
 }
 template void Merger::update<std::vector<float>::const_iterator>
 (const ros::Time &stamp, const std::string &sensor_name,
 std::vector<float>::const_iterator begin, std::vector<float>::const_iterator end);
 
-tactile_msgs::TactileContacts Merger::getContacts() {
-	static ros::Duration timeout(1);
-	ros::Time now = ros::Time::now();
+void Merger::update(const tactile_msgs::TactileState &msg, DispatchTable &table) {
+	const size_t n = msg.sensors.size();
+	if (table.generation_ != generation_) {
+		table.names_.clear();
+		table.channels_.clear();
+		table.generation_ = generation_;
+	}
+	if (table.names_.size() != n) {
+		table.names_.resize(n);
+		table.channels_.resize(n, MergerCore::NONE);
+	}
 
-	tactile_msgs::TactileContacts contacts;
-	for (auto it = groups_.begin(), end = groups_.end(); it != end; ++it) {
-		const GroupDataPtr &data = it->second;
-		boost::unique_lock<boost::mutex> lock(data->mutex);
-		if (data->timestamp + timeout < now)
-			continue; // ignore stalled groups
+	const double stamp = msg.header.stamp.toSec();
+	for (size_t i = 0; i < n; ++i) {
+		const sensor_msgs::ChannelFloat32 &channel = msg.sensors[i];
+		MergerCore::index_t &ch = table.channels_[i];
+		if (table.names_[i] != channel.name) {
+			// (re)build entry for this position
+			table.names_[i] = channel.name;
+			ch = core_.channel(channel.name);
+			if (ch == MergerCore::NONE)
+				ROS_ERROR_STREAM("unknown channel: " << channel.name);
+		}
+		if (ch != MergerCore::NONE)
+			core_.write(ch, channel.values.begin(), channel.values.end(), stamp);
+	}
+}
 
-		tactile_msgs::TactileContact contact;
-		contact.name = it->first; // group name
-		contact.header.frame_id = data->group->frame();
-		contact.header.stamp = data->timestamp;
-		if (!data->group->average(contact))
-			continue; // ignore not contacted groups
+template <typename T>
+static inline void fromEigen(const Eigen::Vector3d &v, T &result) {
+	result.x = v.x();
+	result.y = v.y();
+	result.z = v.z();
+}
 
-		// insert all contacts of the group into result array
-		contacts.contacts.push_back(contact);
-	}
+tactile_msgs::TactileContacts Merger::getContacts() {
+	tactile_msgs::TactileContacts contacts;
+	toMsg(core_.compute(ros::Time::now().toSec()), contacts);
 	return contacts;
 }
 
+void Merger::toMsg(size_t n, tactile_msgs::TactileContacts &contacts) const {
+	const std::vector<MergerCore::Contact> &result = core_.contacts();
+	contacts.contacts.resize(n);
+	for (size_t i = 0; i < n; ++i) {
+		const MergerCore::Contact &c = result[i];
+		tactile_msgs::TactileContact &contact = contacts.contacts[i];
+		contact.name = core_.groupName(c.group); // group name
+		contact.header.frame_id = core_.groupFrame(c.group);
+		toMsg(c, contact);
+	}
+}
+
+void Merger::toMsg(const MergerCore::Contact &c, tactile_msgs::TactileContact &contact) {
+	contact.header.stamp = ros::Time(c.stamp);
+	fromEigen(c.position, contact.position);
+	fromEigen(c.normal, contact.normal);
+	fromEigen(c.force, contact.wrench.force);
+	fromEigen(c.torque, contact.wrench.torque);
+}
+
 } // namespace tactile
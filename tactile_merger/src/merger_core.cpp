@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "merger_core.h"
+#include <Eigen/Geometry>
+
+namespace tactile {
+
+const MergerCore::index_t MergerCore::NONE;
+
+MergerCore::MergerCore()
+   : timeout_(1.0)
+{
+}
+
+void MergerCore::clear()
+{
+	groups_.clear();
+	channels_.clear();
+	contacts_.clear();
+}
+
+MergerCore::index_t MergerCore::addGroup(const std::string &name, const std::string &frame)
+{
+	Group group;
+	group.name = name;
+	group.frame = frame;
+	group.stamp = -std::numeric_limits<double>::infinity();
+	groups_.push_back(group);
+	return groups_.size() - 1;
+}
+
+MergerCore::index_t MergerCore::addTaxel(index_t group, const Eigen::Vector3d &position, const Eigen::Vector3d &normal)
+{
+	Group &g = groups_.at(group);
+	g.positions.push_back(position);
+	g.normals.push_back(normal);
+	g.weights.push_back(0.0);
+	return g.positions.size() - 1;
+}
+
+MergerCore::index_t MergerCore::addGrid(index_t group, const TaxelGrid &grid)
+{
+	Group &g = groups_.at(group);
+	g.grids.push_back(grid);
+	g.grids.back().m0 = g.grids.back().mr = g.grids.back().mc = 0.0;
+	return g.grids.size() - 1;
+}
+
+MergerCore::index_t MergerCore::addChannel(const std::string &name)
+{
+	index_t result = channel(name);
+	if (result != NONE) return result;
+
+	channels_.push_back(std::unique_ptr<Channel>(new Channel));
+	channels_.back()->name = name;
+	channels_.back()->size = 0;
+	return channels_.size() - 1;
+}
+
+MergerCore::index_t MergerCore::channel(const std::string &name) const
+{
+	for (index_t i = 0; i < channels_.size(); ++i)
+		if (channels_[i]->name == name) return i;
+	return NONE;
+}
+
+void MergerCore::mapTaxel(index_t channel, size_t idx, index_t group, index_t taxel)
+{
+	Channel &ch = *channels_.at(channel);
+	TaxelRoute route = {idx, group, taxel};
+	ch.taxels.push_back(route);
+	ch.size = std::max(ch.size, idx + 1);
+}
+
+void MergerCore::mapGrid(index_t channel, index_t group, index_t grid)
+{
+	Channel &ch = *channels_.at(channel);
+	GridRoute route = {group, grid};
+	ch.grids.push_back(route);
+	ch.size = std::max(ch.size, groups_.at(group).grids.at(grid).size());
+}
+
+void MergerCore::finalize()
+{
+	for (auto it = channels_.begin(), end = channels_.end(); it != end; ++it) {
+		const size_t size = (*it)->size;
+		(*it)->buffer.forEach([size](Frame &frame) {
+			frame.values.assign(size, 0.0f);
+			frame.stamp = 0.0;
+		});
+	}
+	// at most one contact per group
+	contacts_.resize(groups_.size());
+}
+
+size_t MergerCore::compute(double now)
+{
+	// fetch latest input of all channels and route it onto taxels and grids
+	for (auto it = channels_.begin(), end = channels_.end(); it != end; ++it) {
+		Channel &ch = **it;
+		if (!ch.buffer.consume()) continue;
+
+		const Frame &frame = ch.buffer.readBuffer();
+		route(ch, frame.values.begin(), frame.values.end(), frame.stamp);
+	}
+
+	size_t n = 0;
+	for (index_t i = 0; i < groups_.size(); ++i) {
+		const Group &g = groups_[i];
+		if (g.stamp + timeout_ < now)
+			continue; // ignore stalled groups
+
+		double sum = 0;
+		Eigen::Vector3d pos = Eigen::Vector3d::Zero();
+		Eigen::Vector3d normal = Eigen::Vector3d::Zero();
+		for (size_t t = 0, tend = g.weights.size(); t != tend; ++t) {
+			const double w = g.weights[t];
+			sum += w;
+			pos += w * g.positions[t];
+			normal += w * g.normals[t];
+		}
+		for (auto grid = g.grids.begin(), gend = g.grids.end(); grid != gend; ++grid) {
+			sum += grid->m0;
+			pos += grid->weightedPosition();
+			normal += grid->m0 * grid->normal;
+		}
+		if (sum <= Eigen::NumTraits<float>::dummy_precision())
+			continue; // ignore not contacted groups
+
+		Contact &contact = contacts_[n++];
+		contact.group = i;
+		contact.stamp = g.stamp;
+		contact.position = pos / sum;
+		contact.normal = normal.normalized();
+		contact.force = (-sum) * contact.normal; // force acts opposite to normal
+		contact.torque = contact.position.cross(contact.force);
+	}
+	return n;
+}
+
+} // namespace tactile
@@ -27,16 +27,17 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "merger.h"
+#include "wrench_aggregator.h"
+#include <tf2_ros/transform_listener.h>
 #include <ros/ros.h>
 #include <tactile_msgs/TactileContacts.h>
 #include <tactile_msgs/TactileState.h>
 #include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
 
-void message_handler(tactile::Merger &merger,
+void message_handler(tactile::Merger &merger, tactile::Merger::DispatchTable &table,
                      const tactile_msgs::TactileStateConstPtr &msg) {
-	for (auto it = msg->sensors.begin(), end = msg->sensors.end(); it != end; ++it) {
-		merger.update(msg->header.stamp, it->name, it->values.begin(), it->values.end());
-	}
+	merger.update(*msg, table);
 }
 
 int main(int argc, char *argv[])
@@ -50,15 +51,43 @@ int main(int argc, char *argv[])
 
 	ros::Publisher pub = nh.advertise<tactile_msgs::TactileContacts>("tactile_contact_states", 5);
 
-	const boost::function<void (const tactile_msgs::TactileStateConstPtr&)>
-	      callback = boost::bind(message_handler, boost::ref(merger), _1);
-	ros::Subscriber sub = nh.subscribe("tactile_states", 1, callback);
+	// subscribe to all source topics directly, each with its own dispatch table
+	std::vector<std::string> sources;
+	if (!nh_priv.getParam("source_list", sources) || sources.empty())
+		sources.push_back("tactile_states");
+	std::vector<tactile::Merger::DispatchTable> tables(sources.size());
+	std::vector<ros::Subscriber> subs;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		const boost::function<void (const tactile_msgs::TactileStateConstPtr&)>
+		      callback = boost::bind(message_handler, boost::ref(merger), boost::ref(tables[i]), _1);
+		subs.push_back(nh.subscribe(sources[i], 1, callback));
+	}
+
+	// optional aggregation of link sets into net wrenches w.r.t. a common frame
+	tactile::WrenchAggregator aggregator;
+	aggregator.load("~wrench_sets");
+	boost::scoped_ptr<tf2_ros::Buffer> tf_buffer;
+	boost::scoped_ptr<tf2_ros::TransformListener> tf_listener;
+	ros::Publisher wrench_pub;
+	if (!aggregator.empty()) {
+		tf_buffer.reset(new tf2_ros::Buffer);
+		tf_listener.reset(new tf2_ros::TransformListener(*tf_buffer));
+		wrench_pub = nh.advertise<tactile_msgs::TactileContacts>("tactile_wrenches", 5);
+	}
 
 	ros::Rate rate(nh_priv.param("rate", 100.));
+	tactile_msgs::TactileContacts wrenches;
 	while (ros::ok())
 	{
 		ros::spinOnce();
-		pub.publish(merger.getContacts());
+		const tactile_msgs::TactileContacts &contacts = merger.getContacts();
+		pub.publish(contacts);
+		if (tf_buffer) {
+			// transforms are refreshed once per cycle and shared by all link sets
+			aggregator.refresh(*tf_buffer);
+			aggregator.aggregate(contacts, wrenches);
+			wrench_pub.publish(wrenches);
+		}
 		rate.sleep();
 	}
 
@@ -29,7 +29,6 @@
 #include "taxel_group.h"
 
 #include <urdf/sensor.h>
-#include <ros/console.h>
 #include <urdf_tactile/taxel_info_iterator.h>
 #include <urdf_tactile/cast.h>
 
@@ -45,6 +44,27 @@ void TaxelGroup::addTaxel(const Taxel &taxel)
 	taxels_.push_back(taxel);
 }
 
+static inline Eigen::Vector3d toEigen(const urdf::Vector3 &v) {
+	return Eigen::Vector3d(v.x, v.y, v.z);
+}
+
+/// grid geometry of a TactileArray sensor attached with given origin
+static TaxelGrid createGrid(const urdf::tactile::TactileArray &array, const urdf::Pose &origin)
+{
+	TaxelGrid grid;
+	grid.rows = array.rows;
+	grid.cols = array.cols;
+	grid.row_major = (array.order == urdf::tactile::TactileArray::ROWMAJOR);
+	// cell (row, col) is located at (row * spacing.x - offset.x, col * spacing.y - offset.y, 0)
+	grid.base = toEigen(origin.position) +
+	            toEigen(origin.rotation * urdf::Vector3(-array.offset.x, -array.offset.y, 0));
+	grid.row_step = toEigen(origin.rotation * urdf::Vector3(array.spacing.x, 0, 0));
+	grid.col_step = toEigen(origin.rotation * urdf::Vector3(0, array.spacing.y, 0));
+	grid.normal = toEigen(origin.rotation * urdf::Vector3(0, 0, 1));
+	grid.m0 = grid.mr = grid.mc = 0;
+	return grid;
+}
+
 static TaxelGroupPtr&
 getGroup(TaxelGroupMap &groups, const std::string &frame) {
 	TaxelGroupMap::iterator it = groups.find(frame);
@@ -57,6 +77,13 @@ void TaxelGroup::addTaxels(const urdf::SensorConstSharedPtr &sensor) {
 	TaxelGroup::TaxelMapping mapping;
 	const urdf::tactile::TactileSensor& tactile = urdf::tactile::tactile_sensor_cast(*sensor);
 
+	if (tactile.array_) {
+		// arrays are not expanded into individual taxels, but handled via their grid moments
+		array_mappings_[tactile.channel_] = arrays_.size();
+		arrays_.push_back(createGrid(*tactile.array_, sensor->origin_));
+		return;
+	}
+
 	for (auto taxel = urdf::tactile::TaxelInfoIterator::begin(sensor),
 	     end = urdf::tactile::TaxelInfoIterator::end(sensor); taxel != end; ++taxel) {
 		mapping[taxel->idx] = size();
@@ -84,54 +111,4 @@ TaxelGroupMap TaxelGroup::load (const std::string &desc_param) {
 	return result;
 }
 
-template <typename Iterator>
-void TaxelGroup::update(const TaxelMapping &mapping, Iterator input_begin, Iterator input_end)
-{
-	for (auto it = mapping.begin(), end = mapping.end(); it != end; ++it) {
-		assert(input_begin + it->first < input_end);
-		taxels_[it->second].weight = *(input_begin + it->first);
-	}
-}
-template void TaxelGroup::update<std::vector<float>::const_iterator>
-(const TaxelMapping &mapping,
-std::vector<float>::const_iterator begin, std::vector<float>::const_iterator end);
-
-
-bool TaxelGroup::average(tactile_msgs::TactileContact &contact)
-{
-	double sum = 0;
-	Eigen::Vector3d pos, normal, force, torque;
-	pos = normal = force = torque = Eigen::Vector3d::Zero();
-	for (auto it = taxels_.begin(), end = taxels_.end(); it != end; ++it) {
-		double w = it->weight;
-		sum += w;
-		pos += w * it->position;
-		normal += w * it->normal;
-	}
-	if (sum > Eigen::NumTraits<float>::dummy_precision()) {
-		pos /= sum;
-		normal.normalize();
-	} else
-		return false;
-
-	contact.position.x = pos.x();
-	contact.position.y = pos.y();
-	contact.position.z = pos.z();
-
-	contact.normal.x = normal.x();
-	contact.normal.y = normal.y();
-	contact.normal.z = normal.z();
-
-	force = (-sum) * normal; // force acts opposite to normal
-	contact.wrench.force.x = force.x();
-	contact.wrench.force.y = force.y();
-	contact.wrench.force.z = force.z();
-
-	torque = pos.cross(force);
-	contact.wrench.torque.x = torque.x();
-	contact.wrench.torque.y = torque.y();
-	contact.wrench.torque.z = torque.z();
-	return true;
-}
-
 } // namespace tactile
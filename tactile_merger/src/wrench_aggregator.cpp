@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "wrench_aggregator.h"
+#include <tf2_ros/buffer.h>
+#include <ros/param.h>
+#include <ros/console.h>
+
+namespace tactile {
+
+static inline Eigen::Vector3d toEigen(const geometry_msgs::Vector3 &v) {
+	return Eigen::Vector3d(v.x, v.y, v.z);
+}
+static inline Eigen::Vector3d toEigen(const geometry_msgs::Point &p) {
+	return Eigen::Vector3d(p.x, p.y, p.z);
+}
+template <typename T>
+static inline void fromEigen(const Eigen::Vector3d &v, T &result) {
+	result.x = v.x();
+	result.y = v.y();
+	result.z = v.z();
+}
+
+void WrenchAggregator::addSet(const std::string &name, const std::string &frame,
+                              const std::vector<std::string> &links)
+{
+	Set set;
+	set.name = name;
+	set.frame = frame;
+	set.links = links;
+	set.poses.resize(links.size(), Eigen::Isometry3d::Identity());
+	set.valid.resize(links.size(), false);
+	for (size_t l = 0; l < links.size(); ++l) {
+		if (links[l] == frame) set.valid[l] = true; // identity
+		links_.insert(std::make_pair(links[l], std::make_pair(sets_.size(), l)));
+	}
+	sets_.push_back(set);
+}
+
+void WrenchAggregator::load(const std::string &param)
+{
+	XmlRpc::XmlRpcValue sets;
+	if (!ros::param::get(param, sets))
+		return;
+	if (sets.getType() != XmlRpc::XmlRpcValue::TypeStruct) {
+		ROS_ERROR("%s is not a struct but type %d", param.c_str(), sets.getType());
+		return;
+	}
+
+	for (auto it = sets.begin(), end = sets.end(); it != end; ++it) {
+		XmlRpc::XmlRpcValue &set = it->second;
+		if (set.getType() != XmlRpc::XmlRpcValue::TypeStruct ||
+		    !set.hasMember("frame") || set["frame"].getType() != XmlRpc::XmlRpcValue::TypeString ||
+		    !set.hasMember("links") || set["links"].getType() != XmlRpc::XmlRpcValue::TypeArray) {
+			ROS_ERROR_STREAM("link set " << it->first << " requires a frame and a list of links");
+			continue;
+		}
+		std::vector<std::string> links;
+		for (int32_t i = 0; i < set["links"].size(); ++i) {
+			if (set["links"][i].getType() == XmlRpc::XmlRpcValue::TypeString)
+				links.push_back(static_cast<std::string>(set["links"][i]));
+		}
+		addSet(it->first, static_cast<std::string>(set["frame"]), links);
+	}
+}
+
+bool WrenchAggregator::refresh(const tf2_ros::Buffer &tf)
+{
+	bool ok = true;
+	for (size_t s = 0; s < sets_.size(); ++s) {
+		Set &set = sets_[s];
+		for (size_t l = 0; l < set.links.size(); ++l) {
+			if (set.links[l] == set.frame) continue;
+			try {
+				const geometry_msgs::Transform &t =
+				      tf.lookupTransform(set.frame, set.links[l], ros::Time(0)).transform;
+				Eigen::Isometry3d &pose = set.poses[l];
+				pose = Eigen::Quaterniond(t.rotation.w, t.rotation.x, t.rotation.y, t.rotation.z);
+				pose.translation() = toEigen(t.translation);
+				set.valid[l] = true;
+			} catch (const tf2::TransformException &e) {
+				ROS_WARN_STREAM_THROTTLE(1, "link set " << set.name << ": " << e.what());
+				ok = false; // keep previous pose
+			}
+		}
+	}
+	return ok;
+}
+
+void WrenchAggregator::setTransform(size_t s, const std::string &link, const Eigen::Isometry3d &pose)
+{
+	Set &set = sets_.at(s);
+	for (size_t l = 0; l < set.links.size(); ++l) {
+		if (set.links[l] != link) continue;
+		set.poses[l] = pose;
+		set.valid[l] = true;
+	}
+}
+
+void WrenchAggregator::aggregate(const tactile_msgs::TactileContacts &contacts,
+                                 tactile_msgs::TactileContacts &result) const
+{
+	struct Sum {
+		Sum() : force(Eigen::Vector3d::Zero()), torque(Eigen::Vector3d::Zero()),
+		        pos(Eigen::Vector3d::Zero()), normal(Eigen::Vector3d::Zero()), weight(0) {}
+		Eigen::Vector3d force, torque, pos, normal;
+		double weight;
+		ros::Time stamp;
+	};
+	std::vector<Sum> sums(sets_.size());
+
+	for (auto it = contacts.contacts.begin(), end = contacts.contacts.end(); it != end; ++it) {
+		auto range = links_.equal_range(it->header.frame_id);
+		for (auto link = range.first; link != range.second; ++link) {
+			const Set &set = sets_[link->second.first];
+			const size_t l = link->second.second;
+			if (!set.valid[l]) continue; // pose not yet known
+
+			const Eigen::Isometry3d &pose = set.poses[l];
+			const Eigen::Vector3d force = pose.linear() * toEigen(it->wrench.force);
+			// shift torque from link origin to frame origin
+			const Eigen::Vector3d torque = pose.linear() * toEigen(it->wrench.torque)
+			                               + pose.translation().cross(force);
+			const double w = force.norm();
+
+			Sum &sum = sums[link->second.first];
+			sum.force += force;
+			sum.torque += torque;
+			sum.pos += w * (pose * toEigen(it->position));
+			sum.normal += w * (pose.linear() * toEigen(it->normal));
+			sum.weight += w;
+			if (it->header.stamp > sum.stamp) sum.stamp = it->header.stamp;
+		}
+	}
+
+	result.contacts.clear();
+	for (size_t s = 0; s < sets_.size(); ++s) {
+		const Sum &sum = sums[s];
+		if (sum.weight <= Eigen::NumTraits<float>::dummy_precision())
+			continue; // ignore not contacted sets
+
+		tactile_msgs::TactileContact contact;
+		contact.name = sets_[s].name;
+		contact.header.frame_id = sets_[s].frame;
+		contact.header.stamp = sum.stamp;
+		fromEigen(sum.pos / sum.weight, contact.position);
+		fromEigen(sum.normal.normalized(), contact.normal);
+		fromEigen(sum.force, contact.wrench.force);
+		fromEigen(sum.torque, contact.wrench.torque);
+		result.contacts.push_back(contact);
+	}
+}
+
+} // namespace tactile
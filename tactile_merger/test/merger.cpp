@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "merger.h"
+
+using namespace tactile;
+
+// the name of our test module
+#define BOOST_TEST_MODULE TACTILE_MERGER_TEST
+// needed for automatic generation of the main()
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+static sensor_msgs::ChannelFloat32 channel(const std::string &name, float value)
+{
+	sensor_msgs::ChannelFloat32 result;
+	result.name = name;
+	result.values.push_back(value);
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_dispatch_table)
+{
+	Merger merger;
+	MergerCore &core = merger.core();
+	const MergerCore::index_t g = core.addGroup("link", "frame");
+	core.mapTaxel(core.addChannel("a"), 0, g, core.addTaxel(g, Eigen::Vector3d(1, 0, 0), Eigen::Vector3d::UnitZ()));
+	core.mapTaxel(core.addChannel("b"), 0, g, core.addTaxel(g, Eigen::Vector3d(0, 1, 0), Eigen::Vector3d::UnitZ()));
+	core.finalize();
+
+	tactile_msgs::TactileState msg;
+	msg.header.stamp = ros::Time(1.0);
+	msg.sensors.push_back(channel("a", 1.0));
+	msg.sensors.push_back(channel("unknown", 5.0));  // ignored
+	msg.sensors.push_back(channel("b", 3.0));
+
+	Merger::DispatchTable table;
+	merger.update(msg, table);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(1.0));
+	BOOST_CHECK_SMALL(0.25 - core.contacts()[0].position.x(), 1e-9);
+	BOOST_CHECK_SMALL(0.75 - core.contacts()[0].position.y(), 1e-9);
+
+	// changed layout of the same topic: entries are rebuilt by name
+	std::swap(msg.sensors[0], msg.sensors[2]);
+	msg.sensors[0].values[0] = 1.0;  // b
+	msg.sensors[2].values[0] = 3.0;  // a
+	merger.update(msg, table);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(1.0));
+	BOOST_CHECK_SMALL(0.75 - core.contacts()[0].position.x(), 1e-9);
+	BOOST_CHECK_SMALL(0.25 - core.contacts()[0].position.y(), 1e-9);
+
+	// fewer channels
+	msg.sensors.resize(1);
+	msg.sensors[0] = channel("a", 0.0);
+	merger.update(msg, table);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(1.0));
+	BOOST_CHECK_SMALL(0.0 - core.contacts()[0].position.x(), 1e-9);
+	BOOST_CHECK_SMALL(1.0 - core.contacts()[0].position.y(), 1e-9);
+
+	tactile_msgs::TactileContacts contacts;
+	merger.toMsg(1, contacts);
+	BOOST_REQUIRE_EQUAL(1u, contacts.contacts.size());
+	BOOST_CHECK_EQUAL("link", contacts.contacts[0].name);
+	BOOST_CHECK_EQUAL("frame", contacts.contacts[0].header.frame_id);
+	BOOST_CHECK_EQUAL(ros::Time(1.0), contacts.contacts[0].header.stamp);
+	BOOST_CHECK_SMALL(-1.0 - contacts.contacts[0].wrench.force.z, 1e-9);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "merger_core.h"
+#include <Eigen/Geometry>
+
+using namespace tactile;
+
+// the name of our test module
+#define BOOST_TEST_MODULE TACTILE_MERGER_CORE_TEST
+// needed for automatic generation of the main()
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+static void expectNear(const Eigen::Vector3d &expected, const Eigen::Vector3d &actual)
+{
+	BOOST_CHECK_SMALL(expected.x() - actual.x(), 1e-6);
+	BOOST_CHECK_SMALL(expected.y() - actual.y(), 1e-6);
+	BOOST_CHECK_SMALL(expected.z() - actual.z(), 1e-6);
+}
+
+/// group "mixed" with three taxels and a 3x4 grid, group "idle" with a single taxel
+struct MergerCoreFixture
+{
+	MergerCoreFixture()
+	{
+		mixed = core.addGroup("mixed", "link");
+		positions = {Eigen::Vector3d(0.1, 0, 0), Eigen::Vector3d(0, 0.2, 0), Eigen::Vector3d(0, 0, 0.3)};
+		normals = {Eigen::Vector3d::UnitX(), Eigen::Vector3d::UnitY(), Eigen::Vector3d::UnitZ()};
+		for (size_t i = 0; i < positions.size(); ++i)
+			core.addTaxel(mixed, positions[i], normals[i]);
+
+		grid.rows = 3;
+		grid.cols = 4;
+		grid.row_major = false;
+		grid.base = Eigen::Vector3d(-0.05, 0.01, 0.02);
+		grid.row_step = Eigen::Vector3d(0.01, 0, 0.002);
+		grid.col_step = Eigen::Vector3d(0, 0.015, 0);
+		grid.normal = grid.row_step.cross(grid.col_step).normalized();
+		core.addGrid(mixed, grid);
+
+		idle = core.addGroup("idle", "other");
+		core.addTaxel(idle, Eigen::Vector3d::Zero(), Eigen::Vector3d::UnitZ());
+
+		// channel "taxels" maps its values in reverse order onto the taxels
+		taxels = core.addChannel("taxels");
+		for (size_t i = 0; i < positions.size(); ++i)
+			core.mapTaxel(taxels, positions.size() - 1 - i, mixed, i);
+		array = core.addChannel("array");
+		core.mapGrid(array, mixed, 0);
+		other = core.addChannel("other");
+		core.mapTaxel(other, 0, idle, 0);
+		core.finalize();
+		core.setTimeout(1.0);
+
+		taxel_values = {0.5f, 1.5f, 1.0f};
+		for (size_t i = 0; i < grid.size(); ++i)
+			array_values.push_back(0.1f * (1 + (3 * i) % 4));
+		other_values = {0.0f};
+	}
+
+	void write(double stamp)
+	{
+		core.write(taxels, taxel_values.begin(), taxel_values.end(), stamp);
+		core.write(array, array_values.begin(), array_values.end(), stamp);
+		core.write(other, other_values.begin(), other_values.end(), stamp);
+	}
+
+	/// contact of group "mixed", computed by expanding the grid into individual taxels
+	void checkContact(const MergerCore::Contact &contact, double stamp)
+	{
+		double sum = 0;
+		Eigen::Vector3d pos = Eigen::Vector3d::Zero(), normal = Eigen::Vector3d::Zero();
+		for (size_t i = 0; i < positions.size(); ++i) {
+			const double w = taxel_values[positions.size() - 1 - i];
+			sum += w;
+			pos += w * positions[i];
+			normal += w * normals[i];
+		}
+		for (unsigned int c = 0, i = 0; c < grid.cols; ++c)  // column-major
+			for (unsigned int r = 0; r < grid.rows; ++r, ++i) {
+				const double w = array_values[i];
+				sum += w;
+				pos += w * (grid.base + r * grid.row_step + c * grid.col_step);
+				normal += w * grid.normal;
+			}
+		pos /= sum;
+		normal.normalize();
+
+		BOOST_CHECK_EQUAL(mixed, contact.group);
+		BOOST_CHECK_EQUAL(stamp, contact.stamp);
+		expectNear(pos, contact.position);
+		expectNear(normal, contact.normal);
+		expectNear(-sum * normal, contact.force);
+		expectNear(pos.cross(-sum * normal), contact.torque);
+	}
+
+	MergerCore core;
+	MergerCore::index_t mixed, idle, taxels, array, other;
+	std::vector<Eigen::Vector3d> positions, normals;
+	TaxelGrid grid;
+	std::vector<float> taxel_values, array_values, other_values;
+};
+
+BOOST_FIXTURE_TEST_CASE(test_lookup, MergerCoreFixture)
+{
+	BOOST_CHECK_EQUAL(2u, core.groups());
+	BOOST_CHECK_EQUAL("mixed", core.groupName(mixed));
+	BOOST_CHECK_EQUAL("link", core.groupFrame(mixed));
+	BOOST_CHECK_EQUAL(3u, core.channels());
+	BOOST_CHECK_EQUAL(array, core.channel("array"));
+	BOOST_CHECK_EQUAL(MergerCore::NONE, core.channel("unknown"));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_compute, MergerCoreFixture)
+{
+	BOOST_CHECK_EQUAL(0u, core.compute(0.0));  // no input yet
+
+	write(1.0);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(1.2));  // idle group is not in contact
+	checkContact(core.contacts()[0], 1.0);
+
+	// without new input, previous values are kept until timeout
+	BOOST_REQUIRE_EQUAL(1u, core.compute(1.9));
+	checkContact(core.contacts()[0], 1.0);
+	BOOST_CHECK_EQUAL(0u, core.compute(2.1));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_read, MergerCoreFixture)
+{
+	// values routed directly by the consumer yield the same contact as buffered ones
+	core.read(taxels, taxel_values.begin(), taxel_values.end(), 1.0);
+	core.read(array, array_values.begin(), array_values.end(), 1.0);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(1.0));
+	checkContact(core.contacts()[0], 1.0);
+
+	// too few values for the grid: only taxels remain in contact
+	const std::vector<float> short_values(array_values.begin(), array_values.end() - 1);
+	core.read(array, short_values.begin(), short_values.end(), 2.0);
+	array_values.assign(array_values.size(), 0.0f);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(2.0));
+	checkContact(core.contacts()[0], 2.0);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_time_jump, MergerCoreFixture)
+{
+	write(10.0);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(10.0));
+
+	// after time jumped backwards, the latest stamp counts
+	write(1.0);
+	BOOST_REQUIRE_EQUAL(1u, core.compute(1.0));
+	BOOST_CHECK_EQUAL(1.0, core.contacts()[0].stamp);
+	BOOST_CHECK_EQUAL(0u, core.compute(2.1));
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "taxel_group.h"
+#include <urdf_tactile/taxel_info_iterator.h>
+#include <urdf_tactile/cast.h>
+
+using namespace tactile;
+using namespace urdf::tactile;
+
+// the name of our test module
+#define BOOST_TEST_MODULE TACTILE_MERGER_TAXEL_GRID_TEST
+// needed for automatic generation of the main()
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+static urdf::SensorSharedPtr createArray(unsigned int rows, unsigned int cols, TactileArray::DataOrder order,
+                                         const urdf::Pose &origin = urdf::Pose())
+{
+	urdf::SensorSharedPtr s(new urdf::Sensor);
+	s->name_ = "array";
+	s->parent_link_ = "link";
+	s->group_ = "array";
+	s->origin_ = origin;
+
+	TactileSensorSharedPtr tactile(new TactileSensor);
+	s->sensor_ = tactile;
+	tactile->channel_ = "channel";
+
+	TactileArraySharedPtr array(new TactileArray);
+	array->order = order;
+	array->rows = rows;
+	array->cols = cols;
+	array->size = Vector2<double>(0.01, 0.02);
+	array->spacing = Vector2<double>(0.01, 0.02);
+	array->offset = Vector2<double>(0.005, 0.03);
+	tactile->array_ = array;
+	return s;
+}
+
+static std::vector<float> createValues(size_t n)
+{
+	std::vector<float> values(n);
+	for (size_t i = 0; i < n; ++i)
+		values[i] = 0.1f * (1 + (7 * i) % 5);
+	return values;
+}
+
+static Eigen::Vector3d toEigen(const urdf::Vector3 &v)
+{
+	return Eigen::Vector3d(v.x, v.y, v.z);
+}
+
+static TaxelGrid createGrid(const urdf::SensorSharedPtr &sensor)
+{
+	TaxelGroup group("link");
+	group.addTaxels(sensor);
+	BOOST_CHECK_EQUAL(group.arrays().size(), 1u);
+	BOOST_CHECK_EQUAL(group.size(), 0u);
+	return group.arrays().at(0);
+}
+
+/// weighted sum of cell positions, expanding the array into individual taxels
+static Eigen::Vector3d expand(const urdf::SensorSharedPtr &sensor, const std::vector<float> &values,
+                              bool link_frame, double &sum)
+{
+	Eigen::Vector3d weighted = Eigen::Vector3d::Zero();
+	sum = 0;
+	for (auto it = TaxelInfoIterator::begin(sensor), end = TaxelInfoIterator::end(sensor); it != end; ++it) {
+		const double w = values[it->idx];
+		sum += w;
+		weighted += w * toEigen(link_frame ? it->geometry_origin.position : it->position);
+	}
+	return weighted;
+}
+
+static void expectNear(const Eigen::Vector3d &expected, const Eigen::Vector3d &actual)
+{
+	BOOST_CHECK_SMALL(expected.x() - actual.x(), 1e-9);
+	BOOST_CHECK_SMALL(expected.y() - actual.y(), 1e-9);
+	BOOST_CHECK_SMALL(expected.z() - actual.z(), 1e-9);
+}
+
+static void testExpansion(TactileArray::DataOrder order)
+{
+	urdf::SensorSharedPtr sensor = createArray(5, 3, order);
+	TaxelGrid grid = createGrid(sensor);
+	const std::vector<float> values = createValues(grid.size());
+	BOOST_REQUIRE(grid.update(values.begin(), values.end()));
+
+	// without sensor origin, grid and per-taxel expansion coincide
+	double sum;
+	const Eigen::Vector3d weighted = expand(sensor, values, false, sum);
+	BOOST_CHECK_SMALL(sum - grid.m0, 1e-9);
+	expectNear(weighted, grid.weightedPosition());
+	expectNear(Eigen::Vector3d::UnitZ(), grid.normal);
+}
+
+BOOST_AUTO_TEST_CASE(test_row_major) { testExpansion(TactileArray::ROWMAJOR); }
+BOOST_AUTO_TEST_CASE(test_column_major) { testExpansion(TactileArray::COLUMNMAJOR); }
+
+BOOST_AUTO_TEST_CASE(test_sensor_origin)
+{
+	urdf::Pose origin;
+	origin.position = urdf::Vector3(0.1, -0.2, 0.3);
+	origin.rotation.setFromRPY(0.3, -0.2, 1.1);
+	urdf::SensorSharedPtr sensor = createArray(4, 6, TactileArray::COLUMNMAJOR, origin);
+	TaxelGrid grid = createGrid(sensor);
+	const std::vector<float> values = createValues(grid.size());
+	BOOST_REQUIRE(grid.update(values.begin(), values.end()));
+
+	// grid positions are expressed w.r.t. the link frame, i.e. they include the sensor origin
+	double sum;
+	const Eigen::Vector3d weighted = expand(sensor, values, true, sum);
+	BOOST_CHECK_SMALL(sum - grid.m0, 1e-9);
+	expectNear(weighted, grid.weightedPosition());
+	expectNear(toEigen(origin.rotation * urdf::Vector3(0, 0, 1)), grid.normal);
+}
+
+BOOST_AUTO_TEST_CASE(test_too_few_values)
+{
+	TaxelGrid grid = createGrid(createArray(3, 3, TactileArray::ROWMAJOR));
+	std::vector<float> values = createValues(grid.size());
+	BOOST_REQUIRE(grid.update(values.begin(), values.end()));
+	BOOST_CHECK_GT(grid.m0, 0.0);
+
+	// moments must not be kept from previous update
+	values.pop_back();
+	BOOST_CHECK(!grid.update(values.begin(), values.end()));
+	BOOST_CHECK_EQUAL(0.0, grid.m0);
+	BOOST_CHECK_EQUAL(0.0, grid.mr);
+	BOOST_CHECK_EQUAL(0.0, grid.mc);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016, Bielefeld University, CITEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "wrench_aggregator.h"
+
+using namespace tactile;
+
+// the name of our test module
+#define BOOST_TEST_MODULE TACTILE_MERGER_WRENCH_AGGREGATOR_TEST
+// needed for automatic generation of the main()
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+static tactile_msgs::TactileContact contact(const std::string &link, const Eigen::Vector3d &position,
+                                            const Eigen::Vector3d &force)
+{
+	// torque w.r.t. link origin, as computed by the merger
+	const Eigen::Vector3d torque = position.cross(force);
+	tactile_msgs::TactileContact c;
+	c.header.frame_id = link;
+	c.header.stamp = ros::Time(1.0);
+	c.position.x = position.x(); c.position.y = position.y(); c.position.z = position.z();
+	c.normal.z = 1.0;
+	c.wrench.force.x = force.x(); c.wrench.force.y = force.y(); c.wrench.force.z = force.z();
+	c.wrench.torque.x = torque.x(); c.wrench.torque.y = torque.y(); c.wrench.torque.z = torque.z();
+	return c;
+}
+
+template <typename T>
+static void expectNear(const Eigen::Vector3d &expected, const T &actual)
+{
+	BOOST_CHECK_SMALL(expected.x() - actual.x, 1e-9);
+	BOOST_CHECK_SMALL(expected.y() - actual.y, 1e-9);
+	BOOST_CHECK_SMALL(expected.z() - actual.z, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(test_net_wrench)
+{
+	WrenchAggregator aggregator;
+	aggregator.addSet("hand", "palm", {"palm", "finger", "thumb"});
+
+	Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+	pose.linear() = (Eigen::AngleAxisd(M_PI / 2, Eigen::Vector3d::UnitZ()) *
+	                 Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitX())).toRotationMatrix();
+	pose.translation() = Eigen::Vector3d(0.1, 0.2, 0.3);
+	aggregator.setTransform(0, "finger", pose);
+	// pose of thumb remains unknown: its contacts are ignored
+
+	const Eigen::Vector3d p1(0.01, 0.02, 0), f1(0, 0, -2.0);
+	const Eigen::Vector3d p2(0.03, -0.01, 0.005), f2(0.5, -1.0, 3.0);
+	tactile_msgs::TactileContacts contacts, result;
+	contacts.contacts.push_back(contact("palm", p1, f1));
+	contacts.contacts.push_back(contact("finger", p2, f2));
+	contacts.contacts.push_back(contact("thumb", p2, f2));
+	contacts.contacts.push_back(contact("other", p2, f2));  // not in any set
+	aggregator.aggregate(contacts, result);
+
+	BOOST_REQUIRE_EQUAL(1u, result.contacts.size());
+	const tactile_msgs::TactileContact &net = result.contacts[0];
+	BOOST_CHECK_EQUAL("hand", net.name);
+	BOOST_CHECK_EQUAL("palm", net.header.frame_id);
+	BOOST_CHECK_EQUAL(ros::Time(1.0), net.header.stamp);
+
+	// net wrench w.r.t. palm origin, computed from contact locations in palm frame
+	const Eigen::Vector3d q2 = pose * p2, g2 = pose.linear() * f2;
+	expectNear(f1 + g2, net.wrench.force);
+	expectNear(p1.cross(f1) + q2.cross(g2), net.wrench.torque);
+	expectNear((f1.norm() * p1 + g2.norm() * q2) / (f1.norm() + g2.norm()), net.position);
+}
+
+BOOST_AUTO_TEST_CASE(test_no_contact)
+{
+	WrenchAggregator aggregator;
+	aggregator.addSet("hand", "palm", {"palm"});
+	tactile_msgs::TactileContacts contacts, result;
+	contacts.contacts.push_back(contact("finger", Eigen::Vector3d::Zero(), Eigen::Vector3d::UnitZ()));
+	aggregator.aggregate(contacts, result);
+	BOOST_CHECK(result.contacts.empty());
+}